@@ -1,24 +1,10 @@
+#include <fstream>
 #include <iostream>
 #include <stdexcept>
-#include <fstream>
+#include <string>
 #include "weather_lib.hpp"
 using namespace std;
 
-bool importForecastFromFile(const std::string& filename, Forecast& obj) {
-    std::ifstream file(filename);
-    if (!file.is_open()) {
-        return false;
-    }
-    WeatherDay day;
-    while (file >> day) {
-        obj += day;
-    }
-    if (file.bad()) {
-        return false;
-    }
-    return true;
-}
-
 void menu() {
     cout << "***************MENU****************" << "\n" 
         << "0. Exit" << "\n" 
@@ -33,8 +19,44 @@ void menu() {
         << "9. Import forecasts from file" << "\n";            // TODO
 }
 
-int main() {
+// Пакетный режим: импорт, очистка, сортировка, слияние дат и запросы по всему файлу
+int runBatch(const string& filename) {
+    ifstream file(filename);
+    if (!file.is_open()) {
+        cerr << "Cannot open " << filename << "\n";
+        return 1;
+    }
+    Forecast forecast;
+    ImportResult imported = importForecast(file, forecast);
+    cout << "Imported: " << imported.imported << ", rejected: " << imported.rejected << "\n";
+    forecast.deleteAllErrors();
+    cout << "After deleting errors: " << forecast.getCount() << "\n";
+    forecast.sortDaysByData();
+    forecast = forecast.mergeSorted(Forecast());
+    cout << "Distinct dates: " << forecast.getCount() << "\n";
+    if (forecast.getCount() == 0) return 0;
+
+    Date first = forecast[0].getDate();
+    Date last = forecast[forecast.getCount() - 1].getDate();
+    cout << "Period: " << first.getDay() << "." << first.getMonth() << "." << first.getYear()
+         << " - " << last.getDay() << "." << last.getMonth() << "." << last.getYear() << "\n";
+    try {
+        cout << "The coldest day\n" << forecast.findColdestDay(Date(0, 1, -999), Date(31, 12, 9999));
+        cout << "The next sunny day\n" << forecast.findNextSunnyDay(first);
+    }
+    catch (const runtime_error& er) {
+        cout << er.what() << "\n";
+    }
+    for (size_t month = 1; month <= 12; month++) {
+        Expected<Forecast> days = forecast.tryGiveAllDaysOfMonth(month);
+        cout << "Month " << month << ": " << (days ? days->getCount() : 0) << " days\n";
+    }
+    return 0;
+}
+
+int runInteractive() {
     Forecast f1 = Forecast();
+    f1.setLazyDeletion(true);
     while(true) {
         menu();
         size_t command;
@@ -126,4 +148,24 @@ int main() {
         cout << f1;
     }
     return 0;
-}
\ No newline at end of file
+}
+
+int main(int argc, char** argv) {
+    string batch_file, trace_file;
+    for (int i = 1; i < argc; i++) {
+        string option = argv[i];
+        if (option == "--batch" && i + 1 < argc) batch_file = argv[++i];
+        else if (option == "--trace" && i + 1 < argc) trace_file = argv[++i];
+        else {
+            cerr << "Usage: " << argv[0] << " [--batch <forecast file>] [--trace <trace.json>]\n";
+            return 2;
+        }
+    }
+    if (!trace_file.empty()) startTracing();
+    int code = batch_file.empty() ? runInteractive() : runBatch(batch_file);
+    if (!trace_file.empty() && !writeTraceFile(trace_file)) {
+        cerr << "Cannot write " << trace_file << "\n";
+        return 1;
+    }
+    return code;
+}
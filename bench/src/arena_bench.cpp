@@ -0,0 +1,118 @@
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <memory_resource>
+#include <new>
+#include <vector>
+
+#include "weather_lib.hpp"
+
+using namespace std;
+
+// Временные результаты giveAllDaysOfMonth в куче и в арене запроса.
+// «Запрос» выполняет MONTH_QUERIES выборок месяца и отбрасывает результаты.
+// Глобальные operator new/delete подсчитывают обращения к куче; при работе
+// через арену куча используется только для её редких блоков.
+
+namespace {
+
+atomic<uint64_t> heap_allocations{0};
+
+constexpr size_t MONTH_QUERIES = 240;
+
+const Forecast& source(size_t size, bool sorted) {
+    static Forecast unsorted_forecast, sorted_forecast;
+    static size_t cached_size = 0;
+    if (cached_size != size) {
+        GeneratorOptions options;
+        options.seed = 20240101;
+        unsorted_forecast = ForecastGenerator(options).makeForecast(size, true);
+        sorted_forecast = ForecastGenerator(options).makeForecast(size);
+        cached_size = size;
+    }
+    return sorted ? sorted_forecast : unsorted_forecast;
+}
+
+void report(benchmark::State& state, uint64_t allocations) {
+    state.counters["heap_allocs_per_request"] = static_cast<double>(allocations) / state.iterations();
+    state.counters["heap_allocs_per_query"] = static_cast<double>(allocations) / (state.iterations() * MONTH_QUERIES);
+    state.SetItemsProcessed(state.iterations() * MONTH_QUERIES);
+}
+
+void BM_MonthQueriesHeap(benchmark::State& state) {
+    const Forecast& forecast = source(state.range(0), state.range(1));
+    uint64_t before = heap_allocations.load(memory_order_relaxed);
+    for (auto _ : state) {
+        for (size_t i = 0; i != MONTH_QUERIES; i++) {
+            Forecast month = forecast.giveAllDaysOfMonth(1 + i % 12);
+            benchmark::DoNotOptimize(month.getCount());
+        }
+    }
+    report(state, heap_allocations.load(memory_order_relaxed) - before);
+}
+
+void BM_MonthQueriesArena(benchmark::State& state) {
+    const Forecast& forecast = source(state.range(0), state.range(1));
+    // Блоки арены переиспользуются между запросами: release() возвращает их пулу
+    pmr::unsynchronized_pool_resource blocks;
+    uint64_t before = heap_allocations.load(memory_order_relaxed);
+    for (auto _ : state) {
+        pmr::monotonic_buffer_resource arena(1 << 16, &blocks);
+        for (size_t i = 0; i != MONTH_QUERIES; i++) {
+            Forecast month = forecast.giveAllDaysOfMonth(1 + i % 12, &arena);
+            benchmark::DoNotOptimize(month.getCount());
+        }
+    }
+    report(state, heap_allocations.load(memory_order_relaxed) - before);
+}
+
+}
+
+// Замены operator new выделяют память через malloc/aligned_alloc, поэтому free в
+// operator delete — парная функция. GCC 12 видит только вызов free для указателя
+// из operator new и выдаёт ложное -Wmismatched-new-delete
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void* operator new(size_t size) {
+    heap_allocations.fetch_add(1, memory_order_relaxed);
+    if (void* pointer = malloc(size ? size : 1)) return pointer;
+    throw bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept {
+    free(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept {
+    free(pointer);
+}
+
+// new_delete_resource() выделяет память выровненной формой operator new
+void* operator new(size_t size, align_val_t alignment) {
+    heap_allocations.fetch_add(1, memory_order_relaxed);
+    size_t align = static_cast<size_t>(alignment);
+    if (void* pointer = aligned_alloc(align, (size + align - 1) / align * align)) return pointer;
+    throw bad_alloc();
+}
+
+void operator delete(void* pointer, align_val_t) noexcept {
+    free(pointer);
+}
+
+void operator delete(void* pointer, size_t, align_val_t) noexcept {
+    free(pointer);
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+// Аргументы: размер прогноза и упорядочен ли он по дате
+BENCHMARK(BM_MonthQueriesHeap)->ArgsProduct({{1000, 10000, 100000}, {0, 1}})->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_MonthQueriesArena)->ArgsProduct({{1000, 10000, 100000}, {0, 1}})->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,108 @@
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+
+#include "weather_lib.hpp"
+
+using namespace std;
+
+namespace {
+
+constexpr size_t FORECASTS = 64;
+constexpr size_t DAYS = 10000;
+constexpr size_t QUERIES = 4096;
+
+// Синтетические прогнозы и запросы, одинаковые при каждом запуске.
+struct Workload {
+    vector<Forecast> forecasts;
+    vector<ForecastQuery> queries;
+
+    Workload() {
+        mt19937 rng(42);
+        uniform_int_distribution<int> temperature(-30, 35);
+        forecasts.resize(FORECASTS);
+        for (Forecast& forecast : forecasts) {
+            vector<WeatherDay> days;
+            days.reserve(DAYS);
+            for (size_t i = 0; i != DAYS; i++) {
+                Weather w; w.setTemperature(temperature(rng));
+                PartsOfDay p; p.setMorning(w); p.setDay(w); p.setEvening(w);
+                days.emplace_back(Date(1 + i % 28, 1 + i / 28 % 12, 2000 + static_cast<int>(i / 336)), 0.0, p);
+            }
+            forecast.append(days);
+        }
+        uniform_int_distribution<size_t> pick(0, FORECASTS - 1);
+        uniform_int_distribution<int> year(2000, 2029);
+        for (size_t i = 0; i != QUERIES; i++) {
+            const Forecast* forecast = &forecasts[pick(rng)];
+            int from = year(rng);
+            if (i % 4 == 3) queries.push_back(MonthQuery{forecast, 1 + i % 12});
+            else queries.push_back(ColdestDayQuery{forecast, Date(1, 1, from), Date(1, 1, from + 3)});
+        }
+    }
+};
+
+const Workload& workload() {
+    static const Workload instance;
+    return instance;
+}
+
+void BM_BatchQueries(benchmark::State& state) {
+    const Workload& data = workload();
+    ThreadPool pool(state.range(0));
+    for (auto _ : state) {
+        vector<QueryResult> results = runBatch(pool, data.queries);
+        benchmark::DoNotOptimize(results.data());
+    }
+    state.SetItemsProcessed(state.iterations() * QUERIES);
+    state.counters["steals"] = static_cast<double>(pool.getStealCount());
+}
+
+void BM_SequentialQueries(benchmark::State& state) {
+    const Workload& data = workload();
+    for (auto _ : state) {
+        for (const ForecastQuery& query : data.queries) {
+            QueryResult result = runQuery(query);
+            benchmark::DoNotOptimize(result);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * QUERIES);
+}
+
+// Серия findColdestDay против одного прохода findColdestDays по тем же диапазонам
+vector<DateRange> coldestRanges(size_t count) {
+    mt19937 rng(7);
+    uniform_int_distribution<int> year(2000, 2029);
+    vector<DateRange> ranges(count);
+    for (DateRange& range : ranges) {
+        int from = year(rng);
+        range = {Date(1, 1, from), Date(1, 1, from + 3)};
+    }
+    return ranges;
+}
+
+void BM_ColdestDayLoop(benchmark::State& state) {
+    const Forecast& forecast = workload().forecasts.front();
+    vector<DateRange> ranges = coldestRanges(state.range(0));
+    for (auto _ : state) {
+        for (const DateRange& range : ranges) benchmark::DoNotOptimize(forecast.findColdestDay(range.from, range.to));
+    }
+    state.SetItemsProcessed(state.iterations() * ranges.size());
+}
+
+void BM_ColdestDaysSweep(benchmark::State& state) {
+    const Forecast& forecast = workload().forecasts.front();
+    vector<DateRange> ranges = coldestRanges(state.range(0));
+    for (auto _ : state) benchmark::DoNotOptimize(forecast.findColdestDays(ranges));
+    state.SetItemsProcessed(state.iterations() * ranges.size());
+}
+
+}
+
+BENCHMARK(BM_ColdestDayLoop)->RangeMultiplier(8)->Range(8, 4096)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ColdestDaysSweep)->RangeMultiplier(8)->Range(8, 4096)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_SequentialQueries)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_BatchQueries)->RangeMultiplier(2)->Range(1, 16)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
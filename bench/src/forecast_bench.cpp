@@ -0,0 +1,283 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <memory_resource>
+#include <random>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "weather_lib.hpp"
+
+using namespace std;
+
+// Набор бенчмарков публичных операций Forecast на синтетических данных.
+// Данные строятся ForecastGenerator с фиксированным seed и одинаковы при
+// каждом запуске. Аргументы: размер набора и доля дубликатов/ошибок в процентах.
+
+namespace {
+
+constexpr uint64_t SEED = 20240101;
+// С 01.01.2000 по 31.12.9999 помещается около 2,9 млн дат
+constexpr uint64_t MAX_DATES = 2900000;
+
+// Кэш последнего набора: бенчмарк вызывается несколько раз с одними и теми же
+// аргументами, а держать в памяти все наборы до 1e7 дней накладно.
+const vector<WeatherDay>& dataset(size_t size, int duplicate_percent = 0, int error_percent = 0) {
+    static tuple<size_t, int, int> key{0, -1, -1};
+    static vector<WeatherDay> days;
+    if (key != make_tuple(size, duplicate_percent, error_percent)) {
+        GeneratorOptions options;
+        options.seed = SEED;
+        options.duplicate_ratio = duplicate_percent / 100.0;
+        options.error_ratio = error_percent / 100.0;
+        // Для больших наборов дата повторяется по станциям: иначе даты
+        // завернулись бы, а слиянию и архиву нужен упорядоченный набор
+        options.stations = static_cast<uint32_t>(max<uint64_t>(1, (size + MAX_DATES - 1) / MAX_DATES));
+        days = ForecastGenerator(options).generate(0, size);
+        key = make_tuple(size, duplicate_percent, error_percent);
+    }
+    return days;
+}
+
+Forecast makeForecast(const vector<WeatherDay>& days) {
+    Forecast forecast;
+    forecast.append(days);
+    return forecast;
+}
+
+void BM_Append(benchmark::State& state) {
+    const vector<WeatherDay>& days = dataset(state.range(0));
+    for (auto _ : state) {
+        Forecast forecast;
+        forecast.append(days);
+        benchmark::DoNotOptimize(forecast.getCount());
+    }
+    state.SetItemsProcessed(state.iterations() * days.size());
+}
+
+void BM_SortDaysByData(benchmark::State& state) {
+    vector<WeatherDay> days = dataset(state.range(0), state.range(1));
+    std::shuffle(days.begin(), days.end(), mt19937_64(SEED));
+    Forecast source = makeForecast(days);
+    for (auto _ : state) {
+        state.PauseTiming();
+        // Собственный буфер: обычная копия разделяет его с source, и detach()
+        // перенёс бы полное копирование в измеряемую операцию
+        Forecast forecast(source, pmr::get_default_resource());
+        state.ResumeTiming();
+        forecast.sortDaysByData();
+        benchmark::DoNotOptimize(forecast.getCount());
+    }
+    state.SetItemsProcessed(state.iterations() * days.size());
+}
+
+void BM_MergeDaysByData(benchmark::State& state) {
+    Forecast source = makeForecast(dataset(state.range(0), state.range(1)));
+    for (auto _ : state) {
+        state.PauseTiming();
+        Forecast forecast(source, pmr::get_default_resource());
+        state.ResumeTiming();
+        forecast.mergeDaysByData();
+        benchmark::DoNotOptimize(forecast.getCount());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_MergeSorted(benchmark::State& state) {
+    const vector<WeatherDay>& days = dataset(state.range(0), state.range(1));
+    // Чётные и нечётные дни: даты источников перемежаются
+    vector<WeatherDay> even, odd;
+    for (size_t i = 0; i != days.size(); i++) (i % 2 == 0 ? even : odd).push_back(days[i]);
+    Forecast first = makeForecast(even);
+    Forecast second = makeForecast(odd);
+    for (auto _ : state) {
+        Forecast merged = first.mergeSorted(second);
+        benchmark::DoNotOptimize(merged.getCount());
+    }
+    state.SetItemsProcessed(state.iterations() * days.size());
+}
+
+void BM_DeleteAllErrors(benchmark::State& state) {
+    Forecast source = makeForecast(dataset(state.range(0), 0, state.range(1)));
+    for (auto _ : state) {
+        state.PauseTiming();
+        Forecast forecast(source, pmr::get_default_resource());
+        state.ResumeTiming();
+        forecast.deleteAllErrors();
+        benchmark::DoNotOptimize(forecast.getCount());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_FindColdestDay(benchmark::State& state) {
+    const vector<WeatherDay>& days = dataset(state.range(0));
+    Forecast forecast = makeForecast(days);
+    Date from = days[days.size() / 4].getDate();
+    Date to = days[days.size() * 3 / 4].getDate();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(forecast.findColdestDay(from, to));
+    }
+    state.SetItemsProcessed(state.iterations() * days.size());
+}
+
+void BM_FindColdestDayPacked(benchmark::State& state) {
+    const vector<WeatherDay>& days = dataset(state.range(0));
+    PackedForecast forecast(makeForecast(days));
+    Date from = days[days.size() / 4].getDate();
+    Date to = days[days.size() * 3 / 4].getDate();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(forecast.findColdestDay(from, to));
+    }
+    state.SetItemsProcessed(state.iterations() * days.size());
+    state.SetBytesProcessed(state.iterations() * days.size() * sizeof(PackedWeatherDay));
+}
+
+void BM_FindNextSunnyDay(benchmark::State& state) {
+    const vector<WeatherDay>& days = dataset(state.range(0));
+    Forecast forecast = makeForecast(days);
+    Date today = days.front().getDate();
+    for (auto _ : state) {
+        try {
+            benchmark::DoNotOptimize(forecast.findNextSunnyDay(today));
+        } catch (const std::runtime_error&) {
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * days.size());
+}
+
+void BM_GiveAllDaysOfMonth(benchmark::State& state) {
+    Forecast forecast = makeForecast(dataset(state.range(0)));
+    for (auto _ : state) {
+        Forecast month = forecast.giveAllDaysOfMonth(7);
+        benchmark::DoNotOptimize(month.getCount());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_ImportForecast(benchmark::State& state) {
+    // Дни, не проходящие check(), записываются испорченными строками
+    string input;
+    char record[MAX_RECORD_LENGTH];
+    for (const WeatherDay& day : dataset(state.range(0), 0, state.range(1))) {
+        if (day.check()) input.append(record, formatWeatherDay(day, record));
+        else input += "broken record";
+        input += '\n';
+    }
+    for (auto _ : state) {
+        istringstream in(input);
+        Forecast forecast;
+        benchmark::DoNotOptimize(importForecast(in, forecast));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetBytesProcessed(state.iterations() * input.size());
+}
+
+void BM_OutputForecast(benchmark::State& state) {
+    Forecast forecast = makeForecast(dataset(state.range(0)));
+    size_t bytes = 0;
+    for (auto _ : state) {
+        ostringstream out;
+        out << forecast;
+        bytes += out.tellp();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetBytesProcessed(bytes);
+}
+
+void BM_ArchiveDecode(benchmark::State& state) {
+    // Пропускная способность считается по логическому объёму: sizeof(WeatherDay) на день
+    const vector<WeatherDay>& days = dataset(state.range(0), 10);
+    ForecastArchive archive(makeForecast(days));
+    vector<WeatherDay> out;
+    out.reserve(days.size());
+    for (auto _ : state) {
+        out.clear();
+        for (size_t block = 0; block != archive.blocks().size(); block++) archive.decodeBlock(block, out);
+        benchmark::DoNotOptimize(out.data());
+    }
+    size_t text_bytes = 0;
+    char record[MAX_RECORD_LENGTH];
+    for (const WeatherDay& day : days) text_bytes += formatWeatherDay(day, record) - record + 1;
+    state.counters["text_ratio"] = static_cast<double>(text_bytes) / archive.compressedBytes();
+    state.SetItemsProcessed(state.iterations() * days.size());
+    state.SetBytesProcessed(state.iterations() * days.size() * sizeof(WeatherDay));
+}
+
+void BM_ArchiveFindColdestDay(benchmark::State& state) {
+    const vector<WeatherDay>& days = dataset(state.range(0), 10);
+    ForecastArchive archive(makeForecast(days));
+    Date from = days.front().getDate();
+    Date to = days.back().getDate();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(archive.findColdestDay(from, to));
+    }
+    state.SetItemsProcessed(state.iterations() * days.size());
+    state.SetBytesProcessed(state.iterations() * days.size() * sizeof(WeatherDay));
+}
+
+void BM_ArchiveDecodeRange(benchmark::State& state) {
+    const vector<WeatherDay>& days = dataset(state.range(0), 10);
+    ForecastArchive archive(makeForecast(days));
+    Date from = days[days.size() / 2].getDate();
+    Date to = days[min(days.size() - 1, days.size() / 2 + 30)].getDate();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(archive.decodeRange(from, to));
+    }
+}
+
+void BM_RollingWindowAppend(benchmark::State& state) {
+    // Окно последних 365 дней: каждый новый день вытесняет самый старый
+    const vector<WeatherDay>& days = dataset(state.range(0));
+    for (auto _ : state) {
+        RollingForecast window(365);
+        for (const WeatherDay& day : days) window += day;
+        benchmark::DoNotOptimize(window.getCount());
+    }
+    state.SetItemsProcessed(state.iterations() * days.size());
+}
+
+void BM_ForecastWindowAppend(benchmark::State& state) {
+    const vector<WeatherDay>& days = dataset(state.range(0));
+    for (auto _ : state) {
+        Forecast window(365);
+        for (const WeatherDay& day : days) {
+            if (window.getCount() == 365) window.deleteByIndex(0);
+            window += day;
+        }
+        benchmark::DoNotOptimize(window.getCount());
+    }
+    state.SetItemsProcessed(state.iterations() * days.size());
+}
+
+// Размеры 1e3..1e7 и доли дубликатов/ошибок 0%, 10%, 50%.
+void sizes(benchmark::internal::Benchmark* bench) {
+    bench->RangeMultiplier(10)->Range(1000, 10000000);
+}
+
+void sizesAndRatios(benchmark::internal::Benchmark* bench) {
+    bench->ArgsProduct({benchmark::CreateRange(1000, 10000000, 10), {0, 10, 50}});
+}
+
+}
+
+BENCHMARK(BM_Append)->Apply(sizes)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_SortDaysByData)->Apply(sizesAndRatios)->Unit(benchmark::kMicrosecond);
+// mergeDaysByData квадратичен, поэтому размеры ограничены 1e4
+BENCHMARK(BM_MergeDaysByData)->ArgsProduct({{1000, 10000}, {0, 10, 50}})->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_MergeSorted)->Apply(sizesAndRatios)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_DeleteAllErrors)->Apply(sizesAndRatios)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_FindColdestDay)->Apply(sizes)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_FindColdestDayPacked)->Apply(sizes)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_FindNextSunnyDay)->Apply(sizes)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_GiveAllDaysOfMonth)->Apply(sizes)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_ImportForecast)->Apply(sizesAndRatios)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_OutputForecast)->Apply(sizes)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_RollingWindowAppend)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_ForecastWindowAppend)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_ArchiveDecode)->Apply(sizes)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_ArchiveFindColdestDay)->Apply(sizes)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_ArchiveDecodeRange)->Apply(sizes)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,98 @@
+#include <benchmark/benchmark.h>
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "weather_lib.hpp"
+#include "spsc_queue.hpp"
+
+using namespace std;
+
+namespace {
+
+constexpr size_t RECORDS = 1 << 20;
+
+// Эталон для сравнения: очередь на мьютексе и условной переменной.
+class MutexQueue {
+private:
+    deque<vector<WeatherDay>> items;
+    mutex lock;
+    condition_variable not_empty;
+
+public:
+    void push(vector<WeatherDay>&& batch) {
+        {
+            lock_guard<mutex> guard(lock);
+            items.push_back(std::move(batch));
+        }
+        not_empty.notify_one();
+    }
+
+    vector<WeatherDay> pop() {
+        unique_lock<mutex> guard(lock);
+        not_empty.wait(guard, [this]() { return !items.empty(); });
+        vector<WeatherDay> batch = std::move(items.front());
+        items.pop_front();
+        return batch;
+    }
+};
+
+vector<WeatherDay> makeBatch(size_t batch_size, size_t first) {
+    vector<WeatherDay> batch(batch_size);
+    for (size_t i = 0; i != batch_size; i++) {
+        batch[i] = WeatherDay(Date(1 + (first + i) % 28, 1, 2024), 0.0, PartsOfDay(), 2);
+    }
+    return batch;
+}
+
+void BM_SpscIngest(benchmark::State& state) {
+    size_t batch_size = state.range(0);
+    for (auto _ : state) {
+        SpscQueue<vector<WeatherDay>> queue(1024);
+        Forecast forecast(RECORDS);
+        thread producer([&queue, batch_size]() {
+            for (size_t sent = 0; sent < RECORDS; sent += batch_size) {
+                vector<WeatherDay> batch = makeBatch(batch_size, sent);
+                while (!queue.tryPush(std::move(batch))) this_thread::yield();
+            }
+        });
+        while (forecast.getCount() < RECORDS) {
+            if (queue.drain([&forecast](vector<WeatherDay>& batch) { forecast.append(batch); }) == 0) {
+                this_thread::yield();
+            }
+        }
+        producer.join();
+        benchmark::DoNotOptimize(forecast.getCount());
+    }
+    state.SetItemsProcessed(state.iterations() * RECORDS);
+}
+
+void BM_MutexIngest(benchmark::State& state) {
+    size_t batch_size = state.range(0);
+    for (auto _ : state) {
+        MutexQueue queue;
+        Forecast forecast(RECORDS);
+        thread producer([&queue, batch_size]() {
+            for (size_t sent = 0; sent < RECORDS; sent += batch_size) {
+                queue.push(makeBatch(batch_size, sent));
+            }
+        });
+        while (forecast.getCount() < RECORDS) {
+            vector<WeatherDay> batch = queue.pop();
+            forecast.append(batch);
+        }
+        producer.join();
+        benchmark::DoNotOptimize(forecast.getCount());
+    }
+    state.SetItemsProcessed(state.iterations() * RECORDS);
+}
+
+}
+
+BENCHMARK(BM_SpscIngest)->RangeMultiplier(16)->Range(1, 4096)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_MutexIngest)->RangeMultiplier(16)->Range(1, 4096)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,179 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+#include "weather_lib.hpp"
+
+using namespace std;
+
+// Пиковый RSS каждой операции Forecast. Перед операцией пик процесса (VmHWM)
+// сбрасывается до текущего RSS записью "5" в /proc/self/clear_refs, после неё
+// читается снова; разница — дополнительная память, которую операция
+// потребовала на пике. Чтобы освобождённые буферы возвращались системе и
+// следующая итерация снова их запрашивала, порог mmap в glibc фиксируется.
+// Счётчик forecast_bytes — Forecast::memoryUsage() результата операции.
+
+namespace {
+
+constexpr uint64_t SEED = 20240101;
+
+size_t readStatusKb(const string& field) {
+    ifstream status("/proc/self/status");
+    string line;
+    while (getline(status, line)) {
+        if (line.compare(0, field.size() + 1, field + ":") == 0) return stoul(line.substr(field.size() + 1));
+    }
+    return 0;
+}
+
+bool resetPeakRss() {
+    ofstream clear_refs("/proc/self/clear_refs");
+    clear_refs << "5";
+    return static_cast<bool>(clear_refs);
+}
+
+const vector<WeatherDay>& dataset(size_t size) {
+    static size_t cached_size = 0;
+    static vector<WeatherDay> days;
+    if (cached_size != size) {
+        GeneratorOptions options;
+        options.seed = SEED;
+        options.duplicate_ratio = 0.1;
+        options.error_ratio = 0.1;
+        days = ForecastGenerator(options).generate(0, size);
+        std::shuffle(days.begin(), days.end(), mt19937_64(SEED));
+        cached_size = size;
+    }
+    return days;
+}
+
+// Выполняет operation в каждой итерации и записывает пиковый прирост RSS.
+template <typename Operation>
+void measure(benchmark::State& state, Operation operation) {
+    size_t peak_delta = 0;
+    size_t forecast_bytes = 0;
+    bool supported = true;
+    for (auto _ : state) {
+        state.PauseTiming();
+        supported = resetPeakRss() && supported;
+        size_t base = readStatusKb("VmRSS");
+        state.ResumeTiming();
+        forecast_bytes = operation().memoryUsage().totalBytes();
+        state.PauseTiming();
+        size_t peak = readStatusKb("VmHWM");
+        peak_delta = max(peak_delta, peak > base ? peak - base : 0);
+        state.ResumeTiming();
+    }
+    if (!supported) state.SkipWithError("/proc/self/clear_refs is not writable");
+    state.counters["peak_rss_delta_kb"] = static_cast<double>(peak_delta);
+    state.counters["forecast_bytes"] = static_cast<double>(forecast_bytes);
+    state.counters["bytes_per_day"] = static_cast<double>(forecast_bytes) / state.range(0);
+}
+
+Forecast build(const vector<WeatherDay>& days) {
+    Forecast forecast;
+    forecast.append(days);
+    return forecast;
+}
+
+void BM_AppendMemory(benchmark::State& state) {
+    const vector<WeatherDay>& days = dataset(state.range(0));
+    measure(state, [&days]() { return build(days); });
+}
+
+void BM_PushBackMemory(benchmark::State& state) {
+    const vector<WeatherDay>& days = dataset(state.range(0));
+    measure(state, [&days]() {
+        Forecast forecast;
+        for (const WeatherDay& day : days) forecast += day;
+        return forecast;
+    });
+}
+
+void BM_SortMemory(benchmark::State& state) {
+    Forecast source = build(dataset(state.range(0)));
+    measure(state, [&source]() {
+        Forecast forecast = source;
+        forecast.sortDaysByData();
+        return forecast;
+    });
+}
+
+void BM_MergeSortedMemory(benchmark::State& state) {
+    Forecast sorted = build(dataset(state.range(0)));
+    sorted.sortDaysByData();
+    measure(state, [&sorted]() { return sorted.mergeSorted(Forecast()); });
+}
+
+void BM_DeleteAllErrorsMemory(benchmark::State& state) {
+    Forecast source = build(dataset(state.range(0)));
+    measure(state, [&source]() {
+        Forecast forecast = source;
+        forecast.deleteAllErrors();
+        return forecast;
+    });
+}
+
+void BM_LazyDeleteMemory(benchmark::State& state) {
+    Forecast source = build(dataset(state.range(0)));
+    measure(state, [&source]() {
+        Forecast forecast = source;
+        forecast.setLazyDeletion(true);
+        forecast.setCompactionThreshold(0.9);
+        for (size_t i = 0; i < forecast.getCount(); i += 2) forecast.deleteByIndex(i);
+        return forecast;
+    });
+}
+
+void BM_GiveAllDaysOfMonthMemory(benchmark::State& state) {
+    Forecast source = build(dataset(state.range(0)));
+    measure(state, [&source]() { return source.giveAllDaysOfMonth(7); });
+}
+
+void BM_ImportMemory(benchmark::State& state) {
+    string text;
+    char record[MAX_RECORD_LENGTH];
+    for (const WeatherDay& day : dataset(state.range(0))) {
+        text.append(record, formatWeatherDay(day, record));
+        text += '\n';
+    }
+    measure(state, [&text]() {
+        istringstream in(text);
+        Forecast forecast;
+        importForecast(in, forecast);
+        return forecast;
+    });
+}
+
+}
+
+BENCHMARK(BM_AppendMemory)->RangeMultiplier(10)->Range(10000, 10000000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_PushBackMemory)->RangeMultiplier(10)->Range(10000, 10000000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_SortMemory)->RangeMultiplier(10)->Range(10000, 10000000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_MergeSortedMemory)->RangeMultiplier(10)->Range(10000, 10000000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_DeleteAllErrorsMemory)->RangeMultiplier(10)->Range(10000, 10000000)->Unit(benchmark::kMillisecond);
+// Ленивое удаление каждого второго дня: O(n log n), размеры до 1e6
+BENCHMARK(BM_LazyDeleteMemory)->RangeMultiplier(10)->Range(10000, 1000000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_GiveAllDaysOfMonthMemory)->RangeMultiplier(10)->Range(10000, 10000000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ImportMemory)->RangeMultiplier(10)->Range(10000, 10000000)->Unit(benchmark::kMillisecond);
+
+int main(int argc, char** argv) {
+#ifdef __GLIBC__
+    mallopt(M_MMAP_THRESHOLD, 128 * 1024);
+    mallopt(M_TRIM_THRESHOLD, 128 * 1024);
+#endif
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,100 @@
+/**
+ * @file async_forecast.hpp
+ * @brief Асинхронные (корутинные) варианты тяжёлых операций над Forecast.
+ *
+ * Операции выполняются на пуле потоков библиотеки (asyncExecutor()), а
+ * ожидающая корутина возобновляется по их завершении, поэтому цикл событий
+ * вызывающего сервиса не блокируется на больших проходах по данным.
+ *
+ * Прогнозы передаются по значению: копирование Forecast стоит O(1) (буфер
+ * разделяется до первого изменения), и вызывающий код может продолжать
+ * работать со своим экземпляром, пока операция выполняется.
+ *
+ * Отмена: каждая операция принимает std::stop_token и проверяет его между
+ * порциями данных. После запроса остановки операция завершается исключением
+ * OperationCancelled.
+ */
+
+#ifndef ASYNC_FORECAST_HPP
+#define ASYNC_FORECAST_HPP
+
+#include <cstddef>
+#include <stop_token>
+#include <string>
+
+#include "date.hpp"
+#include "weather_day.hpp"
+#include "forecast.hpp"
+#include "thread_pool.hpp"
+#include "async_task.hpp"
+
+/**
+ * @brief Возвращает пул потоков, на котором выполняются асинхронные операции библиотеки.
+ *
+ * Пул создаётся при первом обращении с числом потоков по количеству ядер.
+ */
+ThreadPool& asyncExecutor();
+
+/**
+ * @brief Асинхронно импортирует прогнозы из файла.
+ *
+ * @param filename Путь к файлу
+ * @param token    Токен отмены
+ * @return Forecast с прочитанными днями
+ * @throws std::runtime_error если файл не открылся или произошла ошибка чтения
+ * @throws OperationCancelled если отмена запрошена до окончания чтения
+ */
+Task<Forecast> importForecastAsync(std::string filename, std::stop_token token = {});
+
+/**
+ * @brief Асинхронно сортирует прогноз по дате.
+ *
+ * @param forecast Прогноз (копия)
+ * @param token    Токен отмены
+ * @return Отсортированный прогноз
+ * @throws OperationCancelled если отмена запрошена до начала или сразу после сортировки
+ */
+Task<Forecast> sortAsync(Forecast forecast, std::stop_token token = {});
+
+/**
+ * @brief Асинхронно объединяет два прогноза в один, упорядоченный по дате.
+ *
+ * Неотсортированные входы предварительно сортируются, затем сливаются через
+ * Forecast::mergeSorted(): дни с одинаковой датой объединяются WeatherDay::operator+=.
+ *
+ * @param first  Первый прогноз (копия)
+ * @param second Второй прогноз (копия)
+ * @param token  Токен отмены
+ * @return Объединённый прогноз без повторяющихся дат
+ * @throws OperationCancelled если отмена запрошена между этапами
+ */
+Task<Forecast> mergeAsync(Forecast first, Forecast second, std::stop_token token = {});
+
+/**
+ * @brief Асинхронный вариант Forecast::giveAllDaysOfMonth().
+ *
+ * @param forecast Прогноз (копия)
+ * @param month    Номер месяца (1–12)
+ * @param token    Токен отмены
+ * @return Дни месяца, упорядоченные по дате
+ * @throws std::invalid_argument если прогноз пуст или month вне [1,12]
+ * @throws std::runtime_error если в указанном месяце нет прогнозов
+ * @throws OperationCancelled если отмена запрошена во время прохода
+ */
+Task<Forecast> giveAllDaysOfMonthAsync(Forecast forecast, size_t month, std::stop_token token = {});
+
+/**
+ * @brief Асинхронный вариант Forecast::findColdestDay().
+ *
+ * @param forecast Прогноз (копия)
+ * @param from     Начальная дата (не включается)
+ * @param to       Конечная дата (не включается)
+ * @param token    Токен отмены
+ * @return Первый день с минимальной средней температурой
+ * @throws std::invalid_argument если прогноз пуст
+ * @throws std::runtime_error если в диапазоне нет дней
+ * @throws OperationCancelled если отмена запрошена во время прохода
+ */
+Task<WeatherDay> findColdestDayAsync(Forecast forecast, Date from, Date to, std::stop_token token = {});
+
+#endif // ASYNC_FORECAST_HPP
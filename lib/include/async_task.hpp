@@ -0,0 +1,224 @@
+/**
+ * @file async_task.hpp
+ * @brief Шаблон Task — ленивая корутина C++20 с результатом, и вспомогательные ожидания.
+ *
+ * Task запускается только при co_await и по завершении передаёт управление
+ * ожидающей корутине (симметричная передача, без роста стека). schedule()
+ * переносит выполнение корутины на ThreadPool, syncWait() блокирует обычный
+ * поток до завершения задачи.
+ */
+
+#ifndef ASYNC_TASK_HPP
+#define ASYNC_TASK_HPP
+
+#include <coroutine>
+#include <exception>
+#include <latch>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "thread_pool.hpp"
+
+/**
+ * @class OperationCancelled
+ * @brief Исключение, которым завершается операция после запроса остановки через std::stop_token.
+ */
+class OperationCancelled : public std::runtime_error {
+public:
+    OperationCancelled(): std::runtime_error("OPERATION CANCELLED\n") {}
+};
+
+template <typename T = void>
+class Task;
+
+namespace detail {
+
+/**
+ * @brief Общая часть promise_type: продолжение и перехваченное исключение.
+ */
+struct TaskPromiseBase {
+    std::coroutine_handle<> continuation = std::noop_coroutine(); ///< Корутина, ожидающая результата
+    std::exception_ptr error;                                     ///< Исключение тела корутины
+
+    /**
+     * @brief По завершении передаёт управление ожидающей корутине.
+     */
+    struct FinalAwaiter {
+        bool await_ready() const noexcept { return false; }
+
+        template <typename Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+            return handle.promise().continuation;
+        }
+
+        void await_resume() const noexcept {}
+    };
+
+    std::suspend_always initial_suspend() const noexcept { return {}; }
+    FinalAwaiter final_suspend() const noexcept { return {}; }
+    void unhandled_exception() noexcept { error = std::current_exception(); }
+};
+
+template <typename T>
+struct TaskPromise : TaskPromiseBase {
+    std::optional<T> value; ///< Результат корутины
+
+    template <typename Value>
+    void return_value(Value&& result) { value.emplace(std::forward<Value>(result)); }
+
+    T result() {
+        if (error) std::rethrow_exception(error);
+        return std::move(*value);
+    }
+};
+
+template <>
+struct TaskPromise<void> : TaskPromiseBase {
+    void return_void() const noexcept {}
+
+    void result() {
+        if (error) std::rethrow_exception(error);
+    }
+};
+
+/**
+ * @brief Корутина-обёртка для syncWait: сигнализирует latch, когда уже приостановлена.
+ */
+struct SyncWaitTask {
+    struct promise_type {
+        std::latch* done = nullptr;
+
+        struct FinalAwaiter {
+            bool await_ready() const noexcept { return false; }
+            void await_suspend(std::coroutine_handle<promise_type> handle) noexcept { handle.promise().done->count_down(); }
+            void await_resume() const noexcept {}
+        };
+
+        SyncWaitTask get_return_object() { return SyncWaitTask{std::coroutine_handle<promise_type>::from_promise(*this)}; }
+        std::suspend_always initial_suspend() const noexcept { return {}; }
+        FinalAwaiter final_suspend() const noexcept { return {}; }
+        void return_void() const noexcept {}
+        void unhandled_exception() const noexcept { std::terminate(); }
+    };
+
+    std::coroutine_handle<promise_type> handle;
+
+    explicit SyncWaitTask(std::coroutine_handle<promise_type> new_handle): handle(new_handle) {}
+    SyncWaitTask(SyncWaitTask&& other) noexcept: handle(std::exchange(other.handle, {})) {}
+    ~SyncWaitTask() { if (handle) handle.destroy(); }
+};
+
+} // namespace detail
+
+/**
+ * @class Task
+ * @brief Ленивая корутина, возвращающая значение типа T (или void).
+ *
+ * - Тело не начинает выполняться до co_await.
+ * - Исключение из тела сохраняется и повторно выбрасывается в ожидающей корутине.
+ * - Владеет кадром корутины; только перемещается.
+ *
+ * @tparam T Тип результата
+ */
+template <typename T>
+class [[nodiscard]] Task {
+public:
+    struct promise_type : detail::TaskPromise<T> {
+        Task get_return_object() { return Task(std::coroutine_handle<promise_type>::from_promise(*this)); }
+    };
+
+private:
+    std::coroutine_handle<promise_type> handle; ///< Кадр корутины
+
+    explicit Task(std::coroutine_handle<promise_type> new_handle): handle(new_handle) {}
+
+public:
+    Task(Task&& other) noexcept: handle(std::exchange(other.handle, {})) {}
+
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            if (handle) handle.destroy();
+            handle = std::exchange(other.handle, {});
+        }
+        return *this;
+    }
+
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    ~Task() {
+        if (handle) handle.destroy();
+    }
+
+    /**
+     * @brief Запускает задачу и приостанавливает ожидающую корутину до её завершения.
+     *
+     * Ожидающая корутина возобновляется в том потоке, где задача завершилась.
+     */
+    auto operator co_await() && noexcept {
+        struct Awaiter {
+            std::coroutine_handle<promise_type> handle;
+
+            bool await_ready() const noexcept { return !handle || handle.done(); }
+
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+                handle.promise().continuation = awaiting;
+                return handle;
+            }
+
+            T await_resume() { return handle.promise().result(); }
+        };
+        return Awaiter{handle};
+    }
+};
+
+/**
+ * @brief Переносит выполнение текущей корутины на пул потоков.
+ *
+ * Использование: co_await schedule(pool);
+ *
+ * @param pool Пул, в одном из потоков которого корутина продолжится
+ */
+inline auto schedule(ThreadPool& pool) {
+    struct Awaiter {
+        ThreadPool& pool;
+
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> handle) { pool.submit([handle]() { handle.resume(); }); }
+        void await_resume() const noexcept {}
+    };
+    return Awaiter{pool};
+}
+
+/**
+ * @brief Блокирует вызывающий поток до завершения задачи и возвращает её результат.
+ *
+ * Предназначен для кода вне корутин (main, тесты).
+ *
+ * @param task Задача
+ * @return Результат задачи
+ * @throws Исключение, которым завершилась задача
+ */
+template <typename T>
+T syncWait(Task<T> task) {
+    std::latch done(1);
+    std::exception_ptr error;
+    std::conditional_t<std::is_void_v<T>, bool, std::optional<T>> value{};
+    auto wrapper = [](Task<T>& awaited, std::exception_ptr& failure, auto& result) -> detail::SyncWaitTask {
+        try {
+            if constexpr (std::is_void_v<T>) co_await std::move(awaited);
+            else result.emplace(co_await std::move(awaited));
+        } catch (...) {
+            failure = std::current_exception();
+        }
+    }(task, error, value);
+    wrapper.handle.promise().done = &done;
+    wrapper.handle.resume();
+    done.wait();
+    if (error) std::rethrow_exception(error);
+    if constexpr (!std::is_void_v<T>) return std::move(*value);
+}
+
+#endif // ASYNC_TASK_HPP
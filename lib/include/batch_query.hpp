@@ -0,0 +1,91 @@
+/**
+ * @file batch_query.hpp
+ * @brief Пакетное выполнение независимых запросов к прогнозам на пуле потоков.
+ *
+ * Запросы (самый холодный день, ближайший солнечный день, дни месяца) к одному
+ * или разным Forecast отправляются вектором, выполняются параллельно на
+ * ThreadPool и возвращаются в исходном порядке.
+ */
+
+#ifndef BATCH_QUERY_HPP
+#define BATCH_QUERY_HPP
+
+#include <cstddef>
+#include <exception>
+#include <variant>
+#include <vector>
+
+#include "weather_day.hpp"
+#include "forecast.hpp"
+#include "thread_pool.hpp"
+
+/**
+ * @struct ColdestDayQuery
+ * @brief Запрос Forecast::findColdestDay(from, to).
+ */
+struct ColdestDayQuery {
+    const Forecast* forecast; ///< Прогноз, к которому выполняется запрос
+    Date from;                ///< Начальная дата (не включается)
+    Date to;                  ///< Конечная дата (не включается)
+};
+
+/**
+ * @struct NextSunnyDayQuery
+ * @brief Запрос Forecast::findNextSunnyDay(today).
+ */
+struct NextSunnyDayQuery {
+    const Forecast* forecast; ///< Прогноз, к которому выполняется запрос
+    Date today;               ///< Дата, после которой искать
+};
+
+/**
+ * @struct MonthQuery
+ * @brief Запрос Forecast::giveAllDaysOfMonth(month).
+ */
+struct MonthQuery {
+    const Forecast* forecast; ///< Прогноз, к которому выполняется запрос
+    size_t month;             ///< Номер месяца (1–12)
+};
+
+/**
+ * @brief Один запрос пакета.
+ */
+using ForecastQuery = std::variant<ColdestDayQuery, NextSunnyDayQuery, MonthQuery>;
+
+/**
+ * @struct QueryResult
+ * @brief Результат одного запроса пакета.
+ *
+ * При успехе value содержит WeatherDay (для ColdestDayQuery и NextSunnyDayQuery)
+ * или Forecast (для MonthQuery); при ошибке value пуст, а error хранит исключение,
+ * которое выбросил бы соответствующий метод Forecast.
+ */
+struct QueryResult {
+    std::variant<std::monostate, WeatherDay, Forecast> value; ///< Результат запроса
+    std::exception_ptr error;                                 ///< Исключение запроса или nullptr
+};
+
+/**
+ * @brief Выполняет один запрос в текущем потоке.
+ *
+ * @param query Запрос
+ * @return Результат или перехваченное исключение
+ */
+QueryResult runQuery(const ForecastQuery& query);
+
+/**
+ * @brief Выполняет пакет запросов параллельно и возвращает результаты в порядке запросов.
+ *
+ * Запросы режутся на порции по grain штук; каждая порция — отдельная задача пула.
+ * Вызывающий поток, ожидая завершения, сам выполняет задачи пула.
+ * Результат не зависит от количества потоков и порядка выполнения.
+ *
+ * @param pool    Пул потоков
+ * @param queries Запросы; прогнозы не должны изменяться до завершения вызова
+ * @param grain   Количество запросов в одной задаче (> 0)
+ * @return Вектор результатов той же длины, что и queries
+ * @throws std::invalid_argument если grain == 0
+ */
+std::vector<QueryResult> runBatch(ThreadPool& pool, const std::vector<ForecastQuery>& queries, size_t grain = 16);
+
+#endif // BATCH_QUERY_HPP
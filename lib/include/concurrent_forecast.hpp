@@ -0,0 +1,250 @@
+/**
+ * @file concurrent_forecast.hpp
+ * @brief Определение класса ConcurrentForecast — прогноз для одновременной записи и чтения из разных потоков.
+ *
+ * Писатели публикуют неизменяемые версии данных (в стиле RCU), читатели берут
+ * снимок текущей версии без блокировок. Старые версии освобождаются по схеме
+ * эпох (epoch-based reclamation): версия удаляется только тогда, когда ни один
+ * активный снимок не мог её увидеть.
+ */
+
+#ifndef CONCURRENT_FORECAST_HPP
+#define CONCURRENT_FORECAST_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "weather_day.hpp"
+#include "forecast.hpp"
+
+/**
+ * @class ConcurrentForecast
+ * @brief Потокобезопасный контейнер прогнозов со снимками для читателей.
+ *
+ * - Изменения (operator+=, append, deleteByIndex, deleteAllErrors, sortDaysByData)
+ *   сериализуются мьютексом писателей и публикуют новую версию атомарной заменой указателя.
+ * - Добавление дописывает дни в свободный хвост общего буфера: старые версии
+ *   не читают элементы за пределами своего count, поэтому копирования нет.
+ *   Удаление и сортировка строят новый буфер.
+ * - Читатель получает Snapshot без блокировок: занимает слот эпохи (CAS) и
+ *   читает указатель на текущую версию. Снимок неизменен, пока жив, и никогда
+ *   не ждёт писателей.
+ *
+ * @warning Снимки не должны переживать сам ConcurrentForecast.
+ * @note Пока снимок жив, версии, выведенные из оборота после его создания, не освобождаются.
+ */
+class ConcurrentForecast {
+private:
+    /**
+     * @brief Неизменяемая опубликованная версия данных.
+     */
+    struct Version {
+        std::shared_ptr<WeatherDay[]> buffer; ///< Буфер, общий для версий, созданных добавлением
+        size_t capacity;                      ///< Ёмкость буфера
+        size_t count;                         ///< Количество дней, видимых в этой версии
+        uint64_t number;                      ///< Порядковый номер версии
+    };
+
+    /**
+     * @brief Слот читателя: эпоха, в которой был взят снимок, или IDLE.
+     *
+     * Выровнен по кэш-линии, чтобы читатели не мешали друг другу.
+     */
+    struct alignas(64) ReaderSlot {
+        std::atomic<uint64_t> epoch; ///< Эпоха активного снимка
+    };
+
+    static constexpr uint64_t IDLE = UINT64_MAX; ///< Значение свободного слота
+
+    std::atomic<const Version*> current;          ///< Текущая опубликованная версия
+    std::atomic<uint64_t> global_epoch;           ///< Глобальный счётчик эпох
+    std::unique_ptr<ReaderSlot[]> slots;          ///< Слоты читателей
+    size_t max_readers;                           ///< Количество слотов читателей
+    std::mutex writer_lock;                       ///< Сериализует писателей
+    std::vector<std::pair<uint64_t, const Version*>> retired; ///< Выведенные версии и эпохи их вывода
+
+    /**
+     * @brief Публикует новую версию и выводит из оборота предыдущую.
+     *
+     * Вызывается под writer_lock.
+     *
+     * @param next Новая версия (владение передаётся контейнеру)
+     */
+    void publish(Version* next);
+
+    /**
+     * @brief Освобождает выведенные версии, которые не может видеть ни один снимок.
+     *
+     * Вызывается под writer_lock.
+     */
+    void reclaim();
+
+public:
+    /**
+     * @class Snapshot
+     * @brief Неизменяемый снимок одной версии ConcurrentForecast.
+     *
+     * Удерживает слот эпохи, пока жив; только перемещается.
+     */
+    class Snapshot {
+    private:
+        ReaderSlot* slot;       ///< Занятый слот читателя
+        const Version* version; ///< Версия, которую видит снимок
+
+        Snapshot(ReaderSlot* new_slot, const Version* new_version);
+        friend class ConcurrentForecast;
+
+    public:
+        /**
+         * @brief Конструктор перемещения: `other` перестаёт удерживать слот.
+         */
+        Snapshot(Snapshot&& other) noexcept;
+
+        /**
+         * @brief Оператор перемещающего присваивания.
+         */
+        Snapshot& operator=(Snapshot&& other) noexcept;
+
+        Snapshot(const Snapshot&) = delete;
+        Snapshot& operator=(const Snapshot&) = delete;
+
+        /**
+         * @brief Деструктор: освобождает слот читателя.
+         */
+        ~Snapshot();
+
+        /**
+         * @brief Возвращает номер версии, которую видит снимок.
+         */
+        uint64_t getVersion() const;
+
+        /**
+         * @brief Возвращает количество дней в снимке.
+         */
+        size_t getCount() const;
+
+        /**
+         * @brief Возвращает дни снимка как непрерывный диапазон.
+         */
+        std::span<const WeatherDay> days() const;
+
+        /**
+         * @brief Доступ к дню по индексу.
+         *
+         * @param index Индекс (должен быть < getCount())
+         * @return Константная ссылка на WeatherDay
+         * @throws std::out_of_range если index >= getCount()
+         */
+        const WeatherDay& operator[](size_t index) const;
+
+        /**
+         * @brief Находит самый холодный день в диапазоне (from, to).
+         *
+         * @throws std::invalid_argument если снимок пуст
+         * @throws std::runtime_error если в диапазоне нет дней
+         */
+        WeatherDay findColdestDay(const Date& from, const Date& to) const;
+
+        /**
+         * @brief Находит ближайший солнечный день после заданной даты.
+         *
+         * @throws std::invalid_argument если снимок пуст
+         * @throws std::runtime_error если подходящий день не найден
+         */
+        WeatherDay findNextSunnyDay(const Date& today) const;
+
+        /**
+         * @brief Возвращает все дни месяца, упорядоченные по дате.
+         *
+         * @throws std::invalid_argument если снимок пуст или month вне [1,12]
+         * @throws std::runtime_error если в указанном месяце нет прогнозов
+         */
+        Forecast giveAllDaysOfMonth(size_t month) const;
+
+        /**
+         * @brief Копирует снимок в обычный Forecast.
+         */
+        Forecast toForecast() const;
+    };
+
+    /**
+     * @brief Конструктор.
+     *
+     * @param new_max_readers Максимальное количество одновременно живых снимков (> 0)
+     * @throws std::invalid_argument если new_max_readers == 0
+     */
+    explicit ConcurrentForecast(size_t new_max_readers = 64);
+
+    /**
+     * @brief Создаёт потокобезопасный контейнер с содержимым обычного Forecast.
+     *
+     * @param forecast Исходный прогноз
+     * @param new_max_readers Максимальное количество одновременно живых снимков (> 0)
+     */
+    explicit ConcurrentForecast(const Forecast& forecast, size_t new_max_readers = 64);
+
+    /**
+     * @brief Деструктор: освобождает все версии.
+     */
+    ~ConcurrentForecast();
+
+    ConcurrentForecast(const ConcurrentForecast&) = delete;
+    ConcurrentForecast& operator=(const ConcurrentForecast&) = delete;
+
+    /**
+     * @brief Берёт снимок текущей версии без блокировок.
+     *
+     * @return Снимок, неизменный до своего уничтожения
+     * @throws std::runtime_error если одновременно живёт max_readers снимков
+     */
+    Snapshot snapshot() const;
+
+    /**
+     * @brief Добавляет день и публикует новую версию.
+     * @param new_day Добавляемый прогноз
+     * @return Ссылка на *this
+     */
+    ConcurrentForecast& operator+=(const WeatherDay& new_day);
+
+    /**
+     * @brief Добавляет пачку дней одной новой версией.
+     * @param new_days Добавляемые прогнозы
+     */
+    void append(std::span<const WeatherDay> new_days);
+
+    /**
+     * @brief Удаляет день по индексу (строит новый буфер).
+     *
+     * @param index Индекс в текущей версии
+     * @throws std::invalid_argument если index >= количества дней
+     */
+    void deleteByIndex(size_t index);
+
+    /**
+     * @brief Удаляет все некорректные прогнозы (check() == false).
+     */
+    void deleteAllErrors();
+
+    /**
+     * @brief Упорядочивает дни по дате (устойчиво) и публикует результат.
+     */
+    void sortDaysByData();
+
+    /**
+     * @brief Возвращает номер текущей версии.
+     */
+    uint64_t getVersion() const;
+
+    /**
+     * @brief Возвращает количество выведенных, но ещё не освобождённых версий.
+     */
+    size_t getRetiredCount();
+};
+
+#endif // CONCURRENT_FORECAST_HPP
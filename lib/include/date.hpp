@@ -13,6 +13,8 @@
 #include <cstdint>
 #include <istream>
 
+#include "weather_error.hpp"
+
 /**
  * @class Date
  * @brief Представляет календарную дату стандарта ISO (день, месяц, год).
@@ -46,6 +48,34 @@ public:
      */
     Date(uint32_t new_day, uint32_t new_month, int32_t new_year);
 
+    /**
+     * @brief Создаёт дату без исключений.
+     *
+     * @param new_day   День месяца
+     * @param new_month Месяц года
+     * @param new_year  Год
+     * @return Дата или код ошибки первого некорректного компонента
+     */
+    static Expected<Date> tryMake(uint32_t new_day, uint32_t new_month, int32_t new_year);
+
+    /**
+     * @brief Устанавливает день без исключений.
+     * @return WeatherError::InvalidDay, если день > 31; при ошибке дата не меняется
+     */
+    Expected<void> trySetDay(uint32_t new_day);
+
+    /**
+     * @brief Устанавливает месяц без исключений.
+     * @return WeatherError::InvalidMonth, если месяц > 12; при ошибке дата не меняется
+     */
+    Expected<void> trySetMonth(uint32_t new_month);
+
+    /**
+     * @brief Устанавливает год без исключений.
+     * @return WeatherError::InvalidYear, если год вне [-999, 9999]; при ошибке дата не меняется
+     */
+    Expected<void> trySetYear(int32_t new_year);
+
     /**
      * @brief Устанавливает новый день.
      * @param new_day Новое значение дня месяца
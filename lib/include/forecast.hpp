@@ -5,15 +5,56 @@
  * Класс реализует управляемый массив объектов WeatherDay с автоматическим расширением,
  * поддержкой копирования, перемещения, поиска, фильтрации и модификации данных.
  * Использует стратегию удвоения ёмкости при переполнении и уменьшения при сильном опустошении.
+ * Копии разделяют один буфер (копирование при записи), пока одна из них не изменится.
+ * Буферы выделяются из std::pmr::memory_resource, который можно передать в конструктор.
  */
 
 #ifndef FORECAST_HPP
 #define FORECAST_HPP
 
 #include "weather_day.hpp"
+#include "weather_error.hpp"
 #include <algorithm>
 #include <stdexcept>
 #include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <span>
+#include <vector>
+
+/**
+ * @struct DateRange
+ * @brief Диапазон дат (from, to) для пакетных запросов; границы не включаются.
+ */
+struct DateRange {
+    Date from; ///< Начальная дата (не включается)
+    Date to;   ///< Конечная дата (не включается)
+};
+
+/**
+ * @struct MemoryUsage
+ * @brief Разбивка памяти, занимаемой одним Forecast.
+ *
+ * live_bytes + tombstone_bytes + slack_bytes — весь буфер прогнозов (capacity дней).
+ */
+struct MemoryUsage {
+    size_t live_bytes = 0;      ///< Живые дни
+    size_t tombstone_bytes = 0; ///< Дни, помеченные удалёнными и ожидающие уплотнения
+    size_t slack_bytes = 0;     ///< Незанятая ёмкость буфера (capacity - count)
+    size_t index_bytes = 0;     ///< Служебные структуры отложенного удаления
+    size_t cache_bytes = 0;     ///< Оценка памяти кэша запросов
+    size_t buffer_owners = 0;   ///< Количество Forecast, разделяющих буфер (копирование при записи)
+
+    /**
+     * @brief Возвращает сумму всех составляющих в байтах.
+     */
+    size_t totalBytes() const {
+        return live_bytes + tombstone_bytes + slack_bytes + index_bytes + cache_bytes;
+    }
+};
 
 /**
  * @class Forecast
@@ -27,25 +68,127 @@
  * - сортировку и объединение записей с одинаковой датой.
  *
  * @note Внутренний массив может быть больше количества элементов (`capacity >= count`).
+ * @note Копирование выполняется за O(1): копии разделяют буфер со счётчиком ссылок,
+ *       а первое изменяющее обращение к разделяемому буферу делает собственную копию.
  * @warning Не все методы проверяют корректность входных данных — см. описание каждого метода.
  */
 class Forecast {
+public:
+    /**
+     * @brief Функция разрешения конфликта двух прогнозов на одну дату.
+     *
+     * Первый аргумент — уже накопленный в результате день, второй — очередной
+     * день с той же датой. Функция должна объединить их в первом аргументе,
+     * не изменяя его дату.
+     */
+    using DayResolver = std::function<void(WeatherDay&, const WeatherDay&)>;
+
 private:
-    WeatherDay* data;     ///< Указатель на динамический массив прогнозов
+    std::shared_ptr<WeatherDay[]> storage; ///< Буфер прогнозов, разделяемый копиями (копирование при записи)
+    std::pmr::memory_resource* resource;   ///< Источник памяти для новых буферов
+    WeatherDay* data;     ///< Указатель на начало буфера storage
     size_t count;         ///< Текущее количество элементов
     size_t capacity;      ///< Выделенная ёмкость массива
+    bool sorted;          ///< Признак того, что дни упорядочены по дате с момента последней сортировки
+
+    bool lazy_delete;                 ///< Включён ли режим отложенного удаления
+    double compaction_threshold;      ///< Доля «надгробий», при превышении которой выполняется уплотнение
+    size_t tombstones;                ///< Количество помеченных как удалённые элементов
+    std::vector<bool> removed;        ///< Биты «надгробий» по физическим индексам (пуст, пока «надгробий» нет)
+    std::vector<size_t> live_tree;    ///< Дерево Фенвика по живым элементам (1-индексация) для перевода индексов
+
+    struct QueryCache;
+    uint64_t generation;              ///< Номер изменения: увеличивается каждым изменяющим вызовом
+    std::unique_ptr<QueryCache> cache; ///< Кэш результатов запросов (nullptr, если выключен)
 
     /**
      * @brief Изменяет ёмкость внутреннего массива.
      *
-     * Выделяет новый массив указанного размера, копирует существующие данные,
-     * освобождает старый массив.
+     * Выделяет новый массив указанного размера и копирует существующие данные.
+     * Старый буфер освобождается, когда его перестанут разделять все копии.
      *
      * @param new_capacity Новая ёмкость (должна быть ≥ count)
      * @note Не изменяет значение `count`.
      */
     void resize(size_t new_capacity);
 
+    /**
+     * @brief Выделяет буфер прогнозов указанной ёмкости из resource.
+     * @param new_capacity Ёмкость буфера
+     * @return Новый буфер с единственным владельцем
+     */
+    std::shared_ptr<WeatherDay[]> allocateBuffer(size_t new_capacity);
+
+    /**
+     * @brief Делает буфер собственным перед изменением (копирование при записи).
+     *
+     * Если буфер разделяется с другими копиями, копирует данные в новый буфер
+     * той же ёмкости; иначе ничего не делает.
+     */
+    void detach();
+
+    /**
+     * @brief Физически удаляет элемент со сдвигом последующих (исходная стратегия удаления).
+     * @param index Физический индекс (должен быть < count)
+     */
+    void eraseAt(size_t index);
+
+    /**
+     * @brief Переводит логический индекс (без учёта «надгробий») в физический.
+     *
+     * При отсутствии «надгробий» — O(1), иначе спуск по дереву Фенвика за O(log n).
+     *
+     * @param index Логический индекс
+     * @return Физический индекс во внутреннем массиве
+     * @throws std::out_of_range если index >= getCount()
+     */
+    size_t physicalIndex(size_t index) const;
+
+    /**
+     * @brief Проверяет, что элемент с данным физическим индексом не помечен как удалённый.
+     */
+    bool isLiveAt(size_t index) const;
+
+    /**
+     * @brief Строит служебные структуры ленивого режима под текущий count.
+     *
+     * Вызывается при появлении первого «надгробия»; до этого структуры не
+     * занимают памяти, и копирование Forecast остаётся O(1).
+     */
+    void buildIndex();
+
+    /**
+     * @brief Добавляет в служебные структуры ленивого режима только что дописанный элемент.
+     *
+     * Вызывается после увеличения count, пока есть «надгробия». O(log n).
+     */
+    void extendIndex();
+
+    /**
+     * @brief Возвращает результат запроса из кэша или вычисляет и запоминает его.
+     *
+     * Кэш сбрасывается целиком, если generation изменилось с момента заполнения.
+     * Кэшируются только успешные результаты compute.
+     *
+     * @param kind     Тип запроса
+     * @param first    Первый аргумент-дата (или месяц в поле month)
+     * @param second   Второй аргумент-дата
+     * @param compute  Вычисление результата без кэша, возвращает Expected<Value>
+     */
+    template <typename Value, typename Compute>
+    Expected<Value> cachedQuery(unsigned kind, const Date& first, const Date& second, Compute compute) const;
+
+    /**
+     * @brief Собирает живые дни месяца в новый Forecast без кэша.
+     *
+     * Считает подходящие дни заранее, поэтому буфер результата выделяется один раз.
+     *
+     * @param month    Номер месяца (1–12)
+     * @param resource Источник памяти результата
+     * @return Упорядоченные по дате дни месяца или WeatherError::NotFound
+     */
+    Expected<Forecast> collectMonth(size_t month, std::pmr::memory_resource* resource) const;
+
 public:
     /**
      * @brief Конструктор по умолчанию.
@@ -70,10 +213,44 @@ public:
      * @brief Конструктор с заданной начальной ёмкостью.
      *
      * @param initial_capacity Начальная ёмкость (должна быть > 0)
-     * @throws const char* ("INVALID CAPACITY\n") если initial_capacity == 0
+     * @throws std::invalid_argument если initial_capacity == 0
      */
     Forecast(size_t initial_capacity);
 
+    /**
+     * @brief Конструктор с заданной ёмкостью и источником памяти.
+     *
+     * Все буферы прогнозов этого объекта (в том числе при росте и копировании
+     * при записи) выделяются из memory_resource. Источник должен пережить
+     * объект и все его копии, разделяющие буфер.
+     *
+     * @param initial_capacity Начальная ёмкость (должна быть > 0)
+     * @param memory_resource  Источник памяти (не nullptr)
+     * @throws std::invalid_argument если initial_capacity == 0 или memory_resource == nullptr
+     */
+    Forecast(size_t initial_capacity, std::pmr::memory_resource* memory_resource);
+
+    /**
+     * @brief Копирует прогноз в собственный буфер из заданного источника памяти.
+     *
+     * В отличие от конструктора копирования буфер не разделяется с other.
+     * Настройки отложенного удаления копируются, «надгробия» — нет. Если у other
+     * включён кэш запросов, у копии он тоже включён, но начинается пустым.
+     *
+     * @param other           Исходный объект
+     * @param memory_resource Источник памяти (не nullptr)
+     * @throws std::invalid_argument если memory_resource == nullptr
+     */
+    Forecast(const Forecast& other, std::pmr::memory_resource* memory_resource);
+
+    /**
+     * @brief Создаёт пустой контейнер с заданной ёмкостью без исключений.
+     *
+     * @param initial_capacity Начальная ёмкость (должна быть > 0)
+     * @return Forecast или WeatherError::InvalidCapacity
+     */
+    static Expected<Forecast> tryMake(size_t initial_capacity);
+
     /**
      * @brief Деструктор.
      *
@@ -84,10 +261,12 @@ public:
     /**
      * @brief Конструктор копирования.
      *
-     * Создаёт глубокую копию другого Forecast.
+     * Разделяет буфер с `other` за O(1); данные копируются при первом изменении
+     * любой из копий. При наличии «надгробий» копируются их служебные структуры.
+     * Копия использует тот же источник памяти, что и other.
      *
      * @param other Исходный объект
-     * @throws const char* если other.data == nullptr или capacity == 0
+     * @throws std::invalid_argument если other.data == nullptr или capacity == 0
      */
     Forecast(const Forecast& other);
 
@@ -107,11 +286,54 @@ public:
      * Сдвигает последующие элементы влево.
      * При сильном опустошении (count < capacity/3) уменьшает ёмкость в 2 раза.
      *
+     * В ленивом режиме (см. setLazyDeletion()) элемент лишь помечается «надгробием»
+     * за O(log n); физическое удаление откладывается до compact(). Индексы
+     * operator[] при этом ведут себя так же, как при немедленном удалении.
+     *
      * @param index Индекс удаляемого элемента (должен быть < count)
      * @throws std::invalid_argument если index >= count
      */
     void deleteByIndex(size_t index);
 
+    /**
+     * @brief Невыбрасывающий вариант deleteByIndex().
+     * @return WeatherError::InvalidIndex, если index >= getCount()
+     */
+    Expected<void> tryDeleteByIndex(size_t index);
+
+    /**
+     * @brief Включает или выключает режим отложенного (ленивого) удаления.
+     *
+     * При выключении накопленные «надгробия» сразу уплотняются.
+     *
+     * @param enabled true — удалять через «надгробия», false — сдвигом элементов
+     */
+    void setLazyDeletion(bool enabled);
+
+    /**
+     * @brief Возвращает, включён ли режим отложенного удаления.
+     */
+    bool isLazyDeletion() const;
+
+    /**
+     * @brief Задаёт порог автоматического уплотнения.
+     *
+     * Уплотнение запускается из deleteByIndex(), когда доля «надгробий» среди
+     * хранимых элементов превышает порог.
+     *
+     * @param ratio Доля в диапазоне (0, 1]
+     * @throws std::invalid_argument если ratio вне (0, 1]
+     */
+    void setCompactionThreshold(double ratio);
+
+    /**
+     * @brief Физически удаляет все элементы, помеченные «надгробиями».
+     *
+     * Сохраняет относительный порядок оставшихся элементов; при сильном
+     * опустошении уменьшает ёмкость. Сложность O(n).
+     */
+    void compact();
+
     /**
      * @brief Удаляет все некорректные прогнозы (для которых check() == false).
      *
@@ -129,9 +351,31 @@ public:
      * @param to   Конечная дата (не включается)
      * @return Копия самого холодного WeatherDay
      * @throws std::invalid_argument если контейнер пуст
+     * @throws std::runtime_error если в диапазоне нет дней
      * @note Использует std::ranges::filter_view и min_element.
      */
-    WeatherDay findColdestDay(Date from, Date to);
+    WeatherDay findColdestDay(Date from, Date to) const;
+
+    /**
+     * @brief Невыбрасывающий вариант findColdestDay().
+     * @return День или WeatherError::EmptyData / WeatherError::NotFound
+     */
+    Expected<WeatherDay> tryFindColdestDay(const Date& from, const Date& to) const;
+
+    /**
+     * @brief Находит самый холодный день для каждого из диапазонов за один проход.
+     *
+     * Дни упорядочиваются по дате, каждый диапазон превращается в отрезок позиций,
+     * отрезки обрабатываются в порядке правой границы, а минимум поддерживается
+     * монотонным стеком. Сложность O((n + q) log n) вместо O(n·q) у серии вызовов
+     * findColdestDay().
+     *
+     * @param ranges Диапазоны (from, to)
+     * @return Для каждого диапазона — тот же день, что вернул бы findColdestDay(),
+     *         или std::nullopt, если в диапазоне нет дней
+     * @throws std::invalid_argument если контейнер пуст
+     */
+    std::vector<std::optional<WeatherDay>> findColdestDays(std::span<const DateRange> ranges) const;
 
     /**
      * @brief Находит ближайший солнечный день после заданной даты.
@@ -142,7 +386,13 @@ public:
      * @throws std::runtime_error если подходящий день не найден
      * @note Явление должно быть точно Phenomen::Sunny.
      */
-    WeatherDay findNextSunnyDay(const Date& today);
+    WeatherDay findNextSunnyDay(const Date& today) const;
+
+    /**
+     * @brief Невыбрасывающий вариант findNextSunnyDay().
+     * @return День или WeatherError::EmptyData / WeatherError::NotFound
+     */
+    Expected<WeatherDay> tryFindNextSunnyDay(const Date& today) const;
 
     /**
      * @brief Возвращает все прогнозы для указанного месяца.
@@ -154,15 +404,159 @@ public:
      * @throws std::invalid_argument если контейнер пуст или month вне [1,12]
      * @throws std::runtime_error если в указанном месяце нет прогнозов
      */
-    Forecast giveAllDaysOfMonth(size_t month);
+    Forecast giveAllDaysOfMonth(size_t month) const;
+
+    /**
+     * @brief Невыбрасывающий вариант giveAllDaysOfMonth().
+     * @return Дни месяца или WeatherError::EmptyData / WeatherError::InvalidMonth / WeatherError::NotFound
+     */
+    Expected<Forecast> tryGiveAllDaysOfMonth(size_t month) const;
+
+    /**
+     * @brief Возвращает все прогнозы месяца в буфере из заданного источника памяти.
+     *
+     * Предназначен для временных результатов: при передаче
+     * std::pmr::monotonic_buffer_resource результат выделяется одним куском
+     * из арены (и сортируется во временном буфере из неё же), а вся память
+     * освобождается разом вместе с ареной. Арена должна пережить результат.
+     * При включённом кэше запросов результат из кэша копируется в resource.
+     *
+     * @param month    Номер месяца (1–12)
+     * @param resource Источник памяти результата (nullptr — источник по умолчанию)
+     * @throws std::invalid_argument если контейнер пуст или month вне [1,12]
+     * @throws std::runtime_error если в указанном месяце нет прогнозов
+     */
+    Forecast giveAllDaysOfMonth(size_t month, std::pmr::memory_resource* resource) const;
+
+    /**
+     * @brief Невыбрасывающий вариант giveAllDaysOfMonth(month, resource).
+     * @return Дни месяца или WeatherError::EmptyData / WeatherError::InvalidMonth / WeatherError::NotFound
+     */
+    Expected<Forecast> tryGiveAllDaysOfMonth(size_t month, std::pmr::memory_resource* resource) const;
 
     /**
      * @brief Сортирует прогнозы по возрастанию даты.
      *
-     * Использует std::sort с лямбда-функцией сравнения.
+     * Адаптивная сортировка: массив разбивается на уже упорядоченные по дате
+     * серии (например, данные из разных файлов, добавленные через operator+=),
+     * после чего соседние серии попарно сливаются std::merge проходами между
+     * буфером прогноза и одним вспомогательным буфером на count дней.
+     * Для k серий сложность O(n·log k); для уже упорядоченных данных — O(n).
+     *
+     * Вспомогательный буфер (O(n) дополнительной памяти, count · sizeof(WeatherDay)
+     * байт) берётся из источника памяти прогноза на время сортировки и в
+     * memoryUsage() не учитывается; если данные уже упорядочены или состоят из
+     * одной серии, он не выделяется.
+     * Если с момента последней сортировки не добавлялось ничего «не по порядку»
+     * (см. isSorted()), метод возвращается сразу.
+     *
+     * @note Сортировка устойчива: дни с одинаковой датой сохраняют взаимный порядок.
      */
     void sortDaysByData();
 
+    /**
+     * @brief Проверяет признак упорядоченности по дате.
+     *
+     * Признак поддерживается дёшево: operator+= сбрасывает его, только если новый
+     * день раньше последнего, а неконстантный operator[] — всегда (через ссылку
+     * может быть изменена дата). Удаление порядок не нарушает.
+     *
+     * @return true, если дни гарантированно упорядочены по дате; false — если порядок неизвестен.
+     */
+    bool isSorted() const;
+
+    /**
+     * @brief Сливает два упорядоченных по дате прогноза за один проход.
+     *
+     * Выполняет слияние двумя указателями в заранее выделенный результат
+     * (одно выделение памяти, O(n + m)). Все дни с одинаковой датой — как из
+     * разных источников, так и из одного — объединяются в один через resolver,
+     * а если он не задан — через WeatherDay::operator+=.
+     * При равных датах первым в результат попадает день из *this.
+     *
+     * @param other    Второй упорядоченный по дате прогноз
+     * @param resolver Функция объединения дней с одинаковой датой (по умолчанию operator+=)
+     * @return Новый Forecast, упорядоченный по дате и без повторяющихся дат
+     * @throws std::invalid_argument если хотя бы один из прогнозов не упорядочен по дате
+     */
+    Forecast mergeSorted(const Forecast& other, const DayResolver& resolver = {}) const;
+
+    /**
+     * @brief Сливает два упорядоченных по дате прогноза.
+     *
+     * Эквивалентно mergeSorted(other) с объединением через WeatherDay::operator+=.
+     *
+     * @param other Второй упорядоченный по дате прогноз
+     * @return Новый Forecast, упорядоченный по дате и без повторяющихся дат
+     * @throws std::invalid_argument если хотя бы один из прогнозов не упорядочен по дате
+     */
+    Forecast operator|(const Forecast& other) const;
+
+    /**
+     * @brief Возвращает количество прогнозов в контейнере.
+     * @return Количество элементов без учёта помеченных как удалённые.
+     */
+    size_t getCount() const;
+
+    /**
+     * @brief Возвращает ёмкость внутреннего массива.
+     * @return Количество элементов, под которые выделена память (capacity).
+     */
+    size_t getCapacity() const;
+
+    /**
+     * @brief Возвращает источник памяти для буферов прогнозов.
+     */
+    std::pmr::memory_resource* getMemoryResource() const;
+
+    /**
+     * @brief Возвращает разбивку занимаемой памяти.
+     *
+     * Буфер, разделяемый копиями, учитывается полностью в каждой из них;
+     * количество владельцев — в buffer_owners.
+     */
+    MemoryUsage memoryUsage() const;
+
+    /**
+     * @brief Включает или выключает кэш результатов запросов.
+     *
+     * Кэшируются findColdestDay, findNextSunnyDay и giveAllDaysOfMonth по типу
+     * запроса и аргументам. Любой изменяющий вызов (operator+=, append,
+     * deleteByIndex, deleteAllErrors, sortDaysByData, mergeDaysByData,
+     * неконстантный operator[], присваивание) увеличивает номер изменения,
+     * и кэш становится недействительным. Выключение освобождает кэш и
+     * обнуляет счётчики. Копия получает собственный пустой кэш.
+     *
+     * Неконстантный operator[] приостанавливает кэш: запросы вычисляются
+     * заново, пока не будет снова вызван setQueryCache(true). Вызывайте его,
+     * когда изменяемые ссылки больше не используются для записи.
+     *
+     * @param enabled true — включить, false — выключить
+     * @note Константные запросы к кэшируемому объекту можно выполнять из нескольких
+     *       потоков одновременно, как и без кэша.
+     */
+    void setQueryCache(bool enabled);
+
+    /**
+     * @brief Проверяет, включён ли кэш результатов запросов.
+     */
+    bool isQueryCacheEnabled() const;
+
+    /**
+     * @brief Возвращает количество запросов, ответ на которые взят из кэша.
+     */
+    uint64_t getCacheHits() const;
+
+    /**
+     * @brief Возвращает количество кэшируемых запросов, которые пришлось вычислить.
+     */
+    uint64_t getCacheMisses() const;
+
+    /**
+     * @brief Возвращает номер изменения контейнера.
+     */
+    uint64_t getGeneration() const;
+
     /**
      * @brief Объединяет прогнозы с одинаковой датой.
      *
@@ -184,19 +578,46 @@ public:
      */
     Forecast& operator+=(const WeatherDay& newday);
 
+    /**
+     * @brief Добавляет пачку прогнозов в конец контейнера.
+     *
+     * Выполняет не более одного resize на всю пачку (ёмкость удваивается до
+     * достаточной) и копирует дни одним блоком — в отличие от цикла operator+=.
+     *
+     * @param new_days Добавляемые прогнозы
+     */
+    void append(std::span<const WeatherDay> new_days);
+
     /**
      * @brief Доступ к прогнозу по индексу.
      *
      * @param index Индекс (должен быть < count)
      * @return Ссылка на WeatherDay
      * @throws std::out_of_range если index >= count
+     * @note Сбрасывает признак isSorted(), так как через ссылку можно изменить дату.
+     * @note Делает разделяемый буфер собственным — для чтения используйте константную версию.
+     * @note Приостанавливает кэш запросов (см. setQueryCache()): через сохранённую ссылку
+     *       данные могут измениться уже после запроса, и кэш вернул бы устаревший ответ.
+     * @warning Ссылка действительна только до следующего копирования или изменения Forecast.
      */
     WeatherDay& operator[](size_t index);
 
+    /**
+     * @brief Доступ к прогнозу по индексу только для чтения.
+     *
+     * В отличие от неконстантной версии не сбрасывает признак isSorted().
+     *
+     * @param index Индекс (должен быть < count)
+     * @return Константная ссылка на WeatherDay
+     * @throws std::out_of_range если index >= count
+     */
+    const WeatherDay& operator[](size_t index) const;
+
     /**
      * @brief Оператор копирующего присваивания.
      *
-     * Обеспечивает глубокое копирование.
+     * Разделяет буфер с `other` (копирование при записи).
+     * Источник памяти *this не меняется: из него выделяются следующие буферы.
      * Корректно обрабатывает самоприсваивание.
      *
      * @param other Источник
@@ -0,0 +1,184 @@
+/**
+ * @file forecast_archive.hpp
+ * @brief Сжатый архивный формат для упорядоченных по дате прогнозов.
+ *
+ * Архив состоит из блоков (по умолчанию по 4096 дней) и индекса блоков с
+ * первой и последней датой каждого. Каждый блок начинается с абсолютных
+ * значений и декодируется независимо от остальных, поэтому запрос по
+ * диапазону дат находит нужные блоки двоичным поиском по индексу и
+ * распаковывает только их.
+ *
+ * Раскладка блока (все числа — varint, знаковые — в zig-zag):
+ * - количество дней;
+ * - ключ первой даты (год · 512 + месяц · 32 + день) и серии разностей
+ *   ключей соседних дней: varint(длина · 4 + разность) для разностей 0–2,
+ *   иначе varint(длина · 4 + 3) и разность. Для ежедневных данных это
+ *   одна серия единиц на месяц;
+ * - температуры утром, днём и вечером: для каждого дня разности с
+ *   предыдущим днём (у первого дня — сами значения), обычно 1 байт на
+ *   значение. Младший бит вечерней разности — признак дня без осадков;
+ * - осадки дней с осадками: десятые или сотые доли с меткой в младших битах,
+ *   либо 8 байт double, если значение не кратно 0,01 — преобразование всегда
+ *   без потерь;
+ * - явления: серии дней, где явление совпадает с вычисленным по температурам
+ *   и осадкам (как в конструкторе WeatherDay), чередуются с явлениями-
+ *   исключениями: varint(длина серии · 8 + исключение), 0 вместо исключения
+ *   завершает блок. Обычно весь блок — одна серия.
+ */
+
+#ifndef FORECAST_ARCHIVE_HPP
+#define FORECAST_ARCHIVE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <span>
+#include <vector>
+
+#include "date.hpp"
+#include "weather_day.hpp"
+#include "forecast.hpp"
+
+/**
+ * @struct ArchiveBlockInfo
+ * @brief Запись индекса архива: границы блока по датам и положение в данных.
+ */
+struct ArchiveBlockInfo {
+    Date first;         ///< Дата первого дня блока
+    Date last;          ///< Дата последнего дня блока
+    uint32_t count;     ///< Количество дней в блоке
+    uint64_t offset;    ///< Смещение блока в данных архива
+    uint32_t size;      ///< Размер блока в байтах
+};
+
+/**
+ * @brief Кодирует упорядоченные по дате дни в один блок архива.
+ *
+ * @param days Дни в порядке неубывания даты
+ * @param out  Буфер, в конец которого дописывается блок
+ * @throws std::invalid_argument если дни не упорядочены по дате
+ *         или явление-исключение вне [1, 7]
+ */
+void encodeArchiveBlock(std::span<const WeatherDay> days, std::vector<uint8_t>& out);
+
+/**
+ * @brief Декодирует один блок архива.
+ *
+ * @param block Байты блока
+ * @param out   Вектор, в конец которого дописываются дни блока
+ * @return Количество декодированных дней
+ * @throws std::runtime_error если блок повреждён, в том числе если дата или
+ *         температура вне допустимых для Date и Weather значений
+ */
+size_t decodeArchiveBlock(std::span<const uint8_t> block, std::vector<WeatherDay>& out);
+
+/**
+ * @class ForecastArchive
+ * @brief Неизменяемый сжатый архив прогнозов с индексом блоков.
+ */
+class ForecastArchive {
+public:
+    static constexpr size_t DEFAULT_BLOCK_DAYS = 4096; ///< Размер блока по умолчанию (дней)
+
+private:
+    std::vector<uint8_t> data;              ///< Блоки подряд
+    std::vector<ArchiveBlockInfo> index;    ///< Индекс блоков в порядке дат
+    size_t count;                           ///< Общее количество дней
+
+public:
+    /**
+     * @brief Создаёт пустой архив.
+     */
+    ForecastArchive();
+
+    /**
+     * @brief Сжимает упорядоченный по дате прогноз.
+     *
+     * @param forecast   Прогноз с днями в порядке неубывания даты
+     * @param block_days Количество дней в блоке (> 0)
+     * @throws std::invalid_argument если block_days == 0, прогноз не упорядочен
+     *         или содержит явление-исключение вне [1, 7]
+     */
+    explicit ForecastArchive(const Forecast& forecast, size_t block_days = DEFAULT_BLOCK_DAYS);
+
+    /**
+     * @brief Возвращает общее количество дней.
+     */
+    size_t getCount() const;
+
+    /**
+     * @brief Возвращает индекс блоков.
+     */
+    const std::vector<ArchiveBlockInfo>& blocks() const;
+
+    /**
+     * @brief Возвращает байты блока для независимого декодирования.
+     *
+     * @throws std::out_of_range если block >= blocks().size()
+     */
+    std::span<const uint8_t> blockData(size_t block) const;
+
+    /**
+     * @brief Возвращает размер сжатых данных (без индекса) в байтах.
+     */
+    size_t compressedBytes() const;
+
+    /**
+     * @brief Декодирует один блок.
+     *
+     * @param block Номер блока
+     * @param out   Вектор, в конец которого дописываются дни блока
+     * @throws std::out_of_range если block >= blocks().size()
+     * @throws std::runtime_error если блок повреждён
+     */
+    void decodeBlock(size_t block, std::vector<WeatherDay>& out) const;
+
+    /**
+     * @brief Возвращает дни с датами в отрезке [from, to] в порядке дат.
+     *
+     * Декодирует только блоки, пересекающиеся с отрезком.
+     *
+     * @param from Первая дата (включается)
+     * @param to   Последняя дата (включается)
+     * @return Вектор найденных дней (пустой, если дней нет)
+     */
+    std::vector<WeatherDay> decodeRange(const Date& from, const Date& to) const;
+
+    /**
+     * @brief Находит самый холодный день в диапазоне (from, to), как Forecast::findColdestDay.
+     *
+     * Сканирует столбцы распакованных блоков, пересекающихся с диапазоном;
+     * WeatherDay строится только для результата.
+     *
+     * @param from Начальная дата (не включается)
+     * @param to   Конечная дата (не включается)
+     * @return Первый день с минимальной средней температурой
+     * @throws std::invalid_argument если архив пуст
+     * @throws std::runtime_error если в диапазоне нет дней
+     */
+    WeatherDay findColdestDay(const Date& from, const Date& to) const;
+
+    /**
+     * @brief Распаковывает весь архив в Forecast.
+     */
+    Forecast toForecast() const;
+
+    /**
+     * @brief Записывает архив в поток: заголовок, индекс, данные.
+     *
+     * @param out Выходной поток (открытый в двоичном режиме)
+     */
+    void write(std::ostream& out) const;
+
+    /**
+     * @brief Читает архив, записанный write().
+     *
+     * @param in Входной поток (открытый в двоичном режиме)
+     * @return Прочитанный архив
+     * @throws std::runtime_error если заголовок или индекс некорректны
+     */
+    static ForecastArchive read(std::istream& in);
+};
+
+#endif // FORECAST_ARCHIVE_HPP
@@ -0,0 +1,90 @@
+/**
+ * @file forecast_generator.hpp
+ * @brief Детерминированный генератор синтетических прогнозов для бенчмарков и нагрузочных данных.
+ *
+ * День с номером index вычисляется только из seed и index (счётчиковый ГПСЧ
+ * splitmix64), поэтому любую часть набора можно получить независимо и в любом
+ * порядке — например, параллельно из нескольких потоков — и результат всегда
+ * совпадёт с последовательной генерацией.
+ *
+ * Даты идут подряд начиная с start; доля duplicate_ratio дней повторяет дату
+ * предыдущего дня. При stations > 1 каждая дата повторяется для каждой
+ * станции подряд (у станции свой климатический сдвиг температуры), а при
+ * span_days > 0 даты идут по кругу в пределах span_days дней. Без span_days
+ * (или при слишком большом значении) даты заворачиваются после 31.12.9999,
+ * так что генератор не выходит за диапазон Date при любом index.
+ * Температура следует годовому циклу (минимум в середине января) с шумом. Все дни проходят WeatherDay::check(), кроме доли
+ * error_ratio, которая получает температуру вне допустимых пределов.
+ */
+
+#ifndef FORECAST_GENERATOR_HPP
+#define FORECAST_GENERATOR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "date.hpp"
+#include "weather_day.hpp"
+#include "forecast.hpp"
+
+/**
+ * @struct GeneratorOptions
+ * @brief Параметры синтетического набора данных.
+ */
+struct GeneratorOptions {
+    uint64_t seed = 42;                 ///< Зерно генератора
+    Date start = Date(1, 1, 2000);      ///< Дата первого дня
+    double duplicate_ratio = 0.0;       ///< Доля дней с повторяющейся датой, [0, 1)
+    double error_ratio = 0.0;           ///< Доля дней, не проходящих WeatherDay::check(), [0, 1]
+    uint32_t stations = 1;              ///< Количество станций (> 0)
+    uint64_t span_days = 0;             ///< Длина периода дат в днях (0 — до 31.12.9999)
+    int mean_temperature = 10;          ///< Среднегодовая температура
+    int seasonal_amplitude = 18;        ///< Амплитуда годового цикла (0 — без сезонности)
+};
+
+/**
+ * @class ForecastGenerator
+ * @brief Генерирует воспроизводимые по seed прогнозы.
+ */
+class ForecastGenerator {
+private:
+    GeneratorOptions options;
+    int64_t start_day;   ///< Номер дня start от 1970-01-01
+    int64_t period_days; ///< Длина периода дат: span_days, но не дальше 31.12.9999
+
+public:
+    /**
+     * @brief Создаёт генератор.
+     *
+     * @param new_options Параметры набора
+     * @throws std::invalid_argument если duplicate_ratio вне [0, 1), error_ratio вне [0, 1] или stations == 0
+     */
+    explicit ForecastGenerator(const GeneratorOptions& new_options = {});
+
+    /**
+     * @brief Возвращает день с номером index.
+     */
+    WeatherDay at(uint64_t index) const;
+
+    /**
+     * @brief Заполняет out днями с номерами first, first + 1, ...
+     */
+    void fill(uint64_t first, std::span<WeatherDay> out) const;
+
+    /**
+     * @brief Возвращает count дней начиная с номера first.
+     */
+    std::vector<WeatherDay> generate(uint64_t first, size_t count) const;
+
+    /**
+     * @brief Строит прогноз из первых count дней.
+     *
+     * @param count    Количество дней
+     * @param shuffled Перемешать дни (детерминированно по seed), иначе они упорядочены по дате
+     */
+    Forecast makeForecast(size_t count, bool shuffled = false) const;
+};
+
+#endif // FORECAST_GENERATOR_HPP
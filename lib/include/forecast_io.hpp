@@ -0,0 +1,143 @@
+/**
+ * @file forecast_io.hpp
+ * @brief Импорт прогнозов из текстового потока и файла, двоичный формат записей.
+ *
+ * Формат строки совпадает с operator>> для WeatherDay:
+ * "DD.MM.YYYY осадки утро день вечер".
+ *
+ * Двоичный файл — заголовок BinaryHeader и count записей BinaryRecord
+ * фиксированного размера в родном порядке байт. Фиксированный размер
+ * позволяет писать и читать любой диапазон записей по смещению.
+ *
+ * Импорт не использует исключения: строки разбираются через std::from_chars
+ * и невыбрасывающие try-методы, а некорректные записи пропускаются и
+ * подсчитываются. Это важно для «грязных» источников, где доля плохих
+ * записей заметна.
+ */
+
+#ifndef FORECAST_IO_HPP
+#define FORECAST_IO_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <stop_token>
+#include <string>
+#include <string_view>
+
+#include "weather_day.hpp"
+#include "forecast.hpp"
+#include "weather_error.hpp"
+
+/**
+ * @struct ImportResult
+ * @brief Итог импорта.
+ */
+struct ImportResult {
+    size_t imported = 0; ///< Количество добавленных дней
+    size_t rejected = 0; ///< Количество пропущенных некорректных строк
+};
+
+/**
+ * @brief Разбирает одну строку с прогнозом без исключений.
+ *
+ * @param line Строка "DD.MM.YYYY осадки утро день вечер" (пробелы по краям допускаются)
+ * @return WeatherDay с явлением, определённым по температурам и осадкам, или
+ *         WeatherError::ParseError при нарушении формата, или код ошибки проверки значения
+ */
+Expected<WeatherDay> parseWeatherDay(std::string_view line);
+
+/// Максимальная длина записи, формируемой formatWeatherDay()
+constexpr size_t MAX_RECORD_LENGTH = 96;
+
+/**
+ * @brief Записывает день в формате импорта без перевода строки.
+ *
+ * Результат разбирается parseWeatherDay() обратно в тот же день.
+ *
+ * @param day День
+ * @param out Буфер не короче MAX_RECORD_LENGTH
+ * @return Указатель на символ за последним записанным
+ */
+char* formatWeatherDay(const WeatherDay& day, char* out);
+
+/**
+ * @brief Читает прогнозы из потока построчно до конца данных.
+ *
+ * Корректные дни добавляются в obj пачками через Forecast::append(),
+ * некорректные строки пропускаются, пустые строки игнорируются.
+ * После запроса остановки через token чтение прекращается, уже
+ * прочитанные дни остаются в obj.
+ *
+ * @param in    Поток с прогнозами
+ * @param obj   Контейнер, в который добавляются дни
+ * @param token Токен остановки (по умолчанию остановка невозможна)
+ * @return Количество добавленных и пропущенных записей
+ */
+ImportResult importForecast(std::istream& in, Forecast& obj, std::stop_token token = {});
+
+/// Магическое число двоичного файла
+constexpr char BINARY_MAGIC[8] = {'W', 'F', 'B', 'I', 'N', '0', '0', '1'};
+
+/**
+ * @struct BinaryHeader
+ * @brief Заголовок двоичного файла прогнозов.
+ */
+struct BinaryHeader {
+    char magic[8];      ///< BINARY_MAGIC
+    uint64_t count;     ///< Количество записей
+};
+
+/**
+ * @struct BinaryRecord
+ * @brief Прогноз на один день в двоичном файле.
+ */
+struct BinaryRecord {
+    double precipitation;   ///< Осадки
+    int32_t year;           ///< Год
+    int32_t morning;        ///< Температура утром
+    int32_t noon;           ///< Температура днём
+    int32_t evening;        ///< Температура вечером
+    uint8_t day;            ///< День месяца
+    uint8_t month;          ///< Месяц
+    uint8_t phenomen;       ///< Значение Phenomen
+    uint8_t reserved[5];    ///< Выравнивание, заполняется нулями
+};
+
+static_assert(sizeof(BinaryHeader) == 16);
+static_assert(sizeof(BinaryRecord) == 32);
+
+/**
+ * @brief Переводит день в двоичную запись.
+ */
+BinaryRecord toBinaryRecord(const WeatherDay& day);
+
+/**
+ * @brief Восстанавливает день из двоичной записи без исключений.
+ *
+ * @return WeatherDay или код ошибки проверки значения
+ */
+Expected<WeatherDay> fromBinaryRecord(const BinaryRecord& record);
+
+/**
+ * @brief Читает двоичный файл прогнозов из потока.
+ *
+ * Записи с некорректными значениями пропускаются и подсчитываются.
+ *
+ * @param in  Поток, открытый в двоичном режиме
+ * @param obj Контейнер, в который добавляются дни
+ * @return Количество добавленных и пропущенных записей
+ * @throws std::runtime_error если заголовок отсутствует или не совпадает магическое число
+ */
+ImportResult importBinaryForecast(std::istream& in, Forecast& obj);
+
+/**
+ * @brief Импортирует прогнозы из файла.
+ *
+ * @param filename Путь к файлу
+ * @param obj      Контейнер, в который добавляются дни
+ * @return false, если файл не открылся или при чтении произошла ошибка потока
+ */
+bool importForecastFromFile(const std::string& filename, Forecast& obj);
+
+#endif // FORECAST_IO_HPP
@@ -0,0 +1,105 @@
+/**
+ * @file forecast_metrics.hpp
+ * @brief Счётчики горячих путей Forecast, включаемые при сборке.
+ *
+ * Счётчики собираются только при сборке с опцией CMake WEATHER_METRICS
+ * (определяет макрос WEATHER_METRICS). Без неё addMetric() — пустая
+ * constexpr-ветка, которую компилятор удаляет целиком, а снимок состоит из нулей.
+ *
+ * Счётчики глобальные для процесса, увеличиваются атомарно с memory_order_relaxed;
+ * каждый лежит в собственной кэш-линии, чтобы потоки не мешали друг другу.
+ * Снимок читает их по отдельности, поэтому согласован только приблизительно.
+ */
+
+#ifndef FORECAST_METRICS_HPP
+#define FORECAST_METRICS_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#ifdef WEATHER_METRICS
+inline constexpr bool METRICS_ENABLED = true;
+#else
+inline constexpr bool METRICS_ENABLED = false;
+#endif
+
+/**
+ * @enum Metric
+ * @brief Отслеживаемые события.
+ */
+enum class Metric : size_t {
+    Resizes,                ///< Вызовы Forecast::resize (перевыделения буфера)
+    ResizeBytesCopied,      ///< Байт скопировано при перевыделениях
+    Detaches,               ///< Копирования разделяемого буфера перед записью (COW)
+    DetachBytesCopied,      ///< Байт скопировано при копировании разделяемого буфера
+    DeleteShifts,           ///< Элементов сдвинуто при удалении по индексу
+    ScannedColdestDay,      ///< Записей просмотрено findColdestDay
+    ScannedColdestDays,     ///< Записей просмотрено findColdestDays
+    ScannedNextSunnyDay,    ///< Записей просмотрено findNextSunnyDay
+    ScannedDaysOfMonth,     ///< Записей просмотрено giveAllDaysOfMonth
+    CacheHits,              ///< Ответы из кэша запросов
+    CacheMisses,            ///< Вычисленные при включённом кэше ответы
+    Sorts,                  ///< Выполненные сортировки sortDaysByData
+    Count                   ///< Количество счётчиков
+};
+
+constexpr size_t METRIC_COUNT = static_cast<size_t>(Metric::Count);
+
+namespace detail {
+    struct alignas(64) MetricSlot {
+        std::atomic<uint64_t> value{0};
+    };
+
+    extern std::array<MetricSlot, METRIC_COUNT> metric_slots;
+}
+
+/**
+ * @brief Увеличивает счётчик; без WEATHER_METRICS не делает ничего.
+ */
+inline void addMetric(Metric metric, uint64_t value = 1) {
+    if constexpr (METRICS_ENABLED) {
+        detail::metric_slots[static_cast<size_t>(metric)].value.fetch_add(value, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @struct MetricsSnapshot
+ * @brief Значения всех счётчиков на момент снимка.
+ */
+struct MetricsSnapshot {
+    std::array<uint64_t, METRIC_COUNT> values{};
+
+    uint64_t operator[](Metric metric) const {
+        return values[static_cast<size_t>(metric)];
+    }
+};
+
+/**
+ * @brief Возвращает текущие значения счётчиков.
+ */
+MetricsSnapshot metricsSnapshot();
+
+/**
+ * @brief Обнуляет все счётчики.
+ */
+void resetMetrics();
+
+/**
+ * @brief Возвращает имя счётчика в snake_case ("resize_bytes_copied").
+ */
+const char* metricName(Metric metric);
+
+/**
+ * @brief Форматирует снимок как строки "имя значение".
+ */
+std::string formatMetricsText(const MetricsSnapshot& snapshot);
+
+/**
+ * @brief Форматирует снимок как JSON-объект {"enabled": ..., "counters": {...}}.
+ */
+std::string formatMetricsJson(const MetricsSnapshot& snapshot);
+
+#endif // FORECAST_METRICS_HPP
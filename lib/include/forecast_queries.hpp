@@ -0,0 +1,98 @@
+/**
+ * @file forecast_queries.hpp
+ * @brief Обобщённые запросы к прогнозам, хранящимся набором непрерывных сегментов.
+ *
+ * Контейнеры, которые хранят дни не одним массивом (сегментированное хранилище,
+ * кольцевой буфер, снимки), описывают свои данные как диапазон сегментов
+ * std::span<const WeatherDay>. Запросы проходят каждый сегмент простым циклом,
+ * поэтому сканирование идёт с той же скоростью, что и по обычному массиву.
+ *
+ * Семантика запросов совпадает с одноимёнными методами Forecast.
+ */
+
+#ifndef FORECAST_QUERIES_HPP
+#define FORECAST_QUERIES_HPP
+
+#include <concepts>
+#include <cstddef>
+#include <ranges>
+#include <span>
+
+#include "weather_day.hpp"
+#include "forecast.hpp"
+
+/**
+ * @concept DaySegments
+ * @brief Диапазон непрерывных сегментов с прогнозами.
+ */
+template <typename Segments>
+concept DaySegments = std::ranges::input_range<Segments>
+    && std::convertible_to<std::ranges::range_reference_t<Segments>, std::span<const WeatherDay>>;
+
+/**
+ * @brief Находит самый холодный день в диапазоне дат (from, to).
+ *
+ * @param segments Сегменты с прогнозами
+ * @param from     Начальная дата (не включается)
+ * @param to       Конечная дата (не включается)
+ * @return Указатель на первый день с минимальной средней температурой или nullptr, если подходящих дней нет
+ */
+template <DaySegments Segments>
+const WeatherDay* findColdestDayIn(const Segments& segments, const Date& from, const Date& to) {
+    const WeatherDay* coldest = nullptr;
+    for (std::span<const WeatherDay> segment : segments) {
+        for (const WeatherDay& day : segment) {
+            if (!(day.getDate() > from && day.getDate() < to)) continue;
+            if (coldest == nullptr || day.averageTempOfDay() < coldest->averageTempOfDay()) coldest = &day;
+        }
+    }
+    return coldest;
+}
+
+/**
+ * @brief Находит ближайший солнечный день после заданной даты.
+ *
+ * @param segments Сегменты с прогнозами
+ * @param today    Дата, после которой искать
+ * @return Указатель на первый солнечный день с минимальной датой или nullptr, если такого нет
+ */
+template <DaySegments Segments>
+const WeatherDay* findNextSunnyDayIn(const Segments& segments, const Date& today) {
+    const WeatherDay* result = nullptr;
+    for (std::span<const WeatherDay> segment : segments) {
+        for (const WeatherDay& day : segment) {
+            if (day.getPhenomen() != Phenomen::Sunny || !(day.getDate() > today)) continue;
+            if (result == nullptr || day.getDate() < result->getDate()) result = &day;
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Собирает все дни указанного месяца в новый Forecast, упорядоченный по дате.
+ *
+ * Сначала подсчитывает подходящие дни, чтобы выделить результат одним блоком.
+ *
+ * @param segments Сегменты с прогнозами
+ * @param month    Номер месяца (1–12, не проверяется)
+ * @return Forecast с найденными днями (пустой, если дней нет)
+ */
+template <DaySegments Segments>
+Forecast collectDaysOfMonthIn(const Segments& segments, size_t month) {
+    size_t found = 0;
+    for (std::span<const WeatherDay> segment : segments) {
+        for (const WeatherDay& day : segment) {
+            if (day.getDate().getMonth() == month) found++;
+        }
+    }
+    Forecast result(found == 0 ? 1 : found);
+    for (std::span<const WeatherDay> segment : segments) {
+        for (const WeatherDay& day : segment) {
+            if (day.getDate().getMonth() == month) result += day;
+        }
+    }
+    result.sortDaysByData();
+    return result;
+}
+
+#endif // FORECAST_QUERIES_HPP
@@ -0,0 +1,167 @@
+/**
+ * @file forecast_store.hpp
+ * @brief Определение класса ForecastStore — хранилище прогнозов множества метеостанций.
+ *
+ * Станции распределяются по N независимо блокируемым сегментам (шардам) по хешу
+ * идентификатора. Запросы по всем станциям выполняются параллельно по шардам.
+ */
+
+#ifndef FORECAST_STORE_HPP
+#define FORECAST_STORE_HPP
+
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <memory>
+#include <shared_mutex>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "weather_day.hpp"
+#include "forecast.hpp"
+
+/**
+ * @struct ShardUsage
+ * @brief Учёт памяти одного шарда ForecastStore.
+ */
+struct ShardUsage {
+    size_t stations;  ///< Количество станций в шарде
+    size_t days;      ///< Количество хранимых дней
+    size_t bytes;     ///< Оценка занятой памяти: Forecast::memoryUsage() станций, ключи и узлы таблицы
+};
+
+/**
+ * @class ForecastStore
+ * @brief Хранилище прогнозов по идентификатору станции, разделённое на шарды.
+ *
+ * Каждый шард — хеш-таблица «станция → Forecast» под собственным std::shared_mutex,
+ * поэтому запись в разные шарды не конкурирует.
+ * Пакетные запросы под разделяемой блокировкой шарда только копируют его
+ * прогнозы (O(1) благодаря копированию при записи), а сканируют их уже без
+ * блокировки — писатели не ждут окончания длинных запросов.
+ */
+class ForecastStore {
+private:
+    /**
+     * @brief Один шард: станции и их блокировка.
+     */
+    struct Shard {
+        mutable std::shared_mutex lock;                       ///< Блокировка шарда
+        std::unordered_map<std::string, Forecast> stations;   ///< Прогнозы станций шарда
+    };
+
+    std::vector<std::unique_ptr<Shard>> shards; ///< Шарды хранилища
+
+    /**
+     * @brief Возвращает шард, к которому относится станция.
+     */
+    Shard& shardFor(const std::string& station) const;
+
+    /**
+     * @brief Выполняет action параллельно для копий прогнозов каждого шарда.
+     *
+     * @param action Вызывается для каждой станции с её прогнозом
+     * @return Результаты, собранные в порядке возрастания идентификатора станции
+     */
+    std::map<std::string, WeatherDay> collectPerStation(
+        const std::function<bool(const Forecast&, WeatherDay&)>& action) const;
+
+public:
+    /**
+     * @brief Конструктор.
+     *
+     * @param shard_count Количество шардов (> 0)
+     * @throws std::invalid_argument если shard_count == 0
+     */
+    explicit ForecastStore(size_t shard_count = 16);
+
+    /**
+     * @brief Добавляет день в прогноз станции (создаёт станцию при необходимости).
+     *
+     * @param station Идентификатор станции
+     * @param day     Добавляемый прогноз
+     */
+    void add(const std::string& station, const WeatherDay& day);
+
+    /**
+     * @brief Добавляет пачку дней в прогноз станции (создаёт станцию при необходимости).
+     *
+     * @param station Идентификатор станции
+     * @param days    Добавляемые прогнозы
+     */
+    void append(const std::string& station, std::span<const WeatherDay> days);
+
+    /**
+     * @brief Изменяет прогноз станции под монопольной блокировкой её шарда.
+     *
+     * @param station Идентификатор станции (создаётся при необходимости)
+     * @param action  Действие над прогнозом
+     */
+    void update(const std::string& station, const std::function<void(Forecast&)>& action);
+
+    /**
+     * @brief Удаляет станцию.
+     *
+     * @param station Идентификатор станции
+     * @return true, если станция существовала
+     */
+    bool removeStation(const std::string& station);
+
+    /**
+     * @brief Проверяет наличие станции.
+     */
+    bool contains(const std::string& station) const;
+
+    /**
+     * @brief Возвращает копию прогноза станции (O(1), копирование при записи).
+     *
+     * @param station Идентификатор станции
+     * @return Прогноз станции
+     * @throws std::out_of_range если станции нет
+     */
+    Forecast getForecast(const std::string& station) const;
+
+    /**
+     * @brief Возвращает общее количество станций.
+     */
+    size_t getStationCount() const;
+
+    /**
+     * @brief Возвращает количество шардов.
+     */
+    size_t getShardCount() const;
+
+    /**
+     * @brief Находит самый холодный день в диапазоне (from, to) для каждой станции.
+     *
+     * Шарды обрабатываются параллельно. Станции без дней в диапазоне в результат не входят.
+     *
+     * @param from Начальная дата (не включается)
+     * @param to   Конечная дата (не включается)
+     * @return Отображение «станция → самый холодный день»
+     */
+    std::map<std::string, WeatherDay> findColdestDays(const Date& from, const Date& to) const;
+
+    /**
+     * @brief Находит ближайший солнечный день после даты для каждой станции.
+     *
+     * Шарды обрабатываются параллельно. Станции без солнечных дней в результат не входят.
+     *
+     * @param today Дата, после которой искать
+     * @return Отображение «станция → ближайший солнечный день»
+     */
+    std::map<std::string, WeatherDay> findNextSunnyDays(const Date& today) const;
+
+    /**
+     * @brief Возвращает учёт памяти по каждому шарду.
+     *
+     * Буферы прогнозов, разделяемые с внешними копиями, учитываются целиком.
+     *
+     * @return Вектор длиной getShardCount()
+     */
+    std::vector<ShardUsage> memoryUsage() const;
+};
+
+#endif // FORECAST_STORE_HPP
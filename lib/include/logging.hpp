@@ -0,0 +1,106 @@
+/**
+ * @file logging.hpp
+ * @brief Диагностический журнал библиотеки с фильтрацией уровня при сборке.
+ *
+ * Минимальный уровень задаётся при сборке макросом WEATHER_LOG_LEVEL
+ * (опция CMake с тем же именем, по умолчанию Info). Вызов logMessage() с
+ * уровнем ниже собранного — пустая constexpr-ветка: сообщение не
+ * форматируется и ввода-вывода нет. Поэтому подробные сообщения на горячих
+ * путях (Trace, Debug) ничего не стоят в обычной сборке.
+ *
+ * Каждая категория пишет в свой приёмник (sink). По умолчанию все категории
+ * пишут в std::cerr; пустой приёмник отключает категорию.
+ */
+
+#ifndef LOGGING_HPP
+#define LOGGING_HPP
+
+#include <cstddef>
+#include <functional>
+#include <sstream>
+#include <string_view>
+
+/**
+ * @enum LogLevel
+ * @brief Уровень важности сообщения.
+ */
+enum class LogLevel {
+    Trace = 0,  ///< Каждое действие на горячем пути
+    Debug,      ///< Подробности операций
+    Info,       ///< Заметные события
+    Warning,    ///< Подозрительные, но обработанные ситуации
+    Error,      ///< Ошибки
+    Off         ///< Журнал выключен
+};
+
+/**
+ * @enum LogCategory
+ * @brief Источник сообщения; у каждой категории свой приёмник.
+ */
+enum class LogCategory {
+    Forecast,   ///< Изменения контейнера Forecast
+    Query,      ///< Запросы и кэш запросов
+    Io,         ///< Импорт и экспорт
+    Count       ///< Количество категорий
+};
+
+#ifndef WEATHER_LOG_LEVEL
+#define WEATHER_LOG_LEVEL 2
+#endif
+
+/// Минимальный уровень, попадающий в сборку
+inline constexpr LogLevel COMPILED_LOG_LEVEL = static_cast<LogLevel>(WEATHER_LOG_LEVEL);
+
+/**
+ * @brief Приёмник сообщений.
+ */
+using LogSink = std::function<void(LogLevel, LogCategory, std::string_view)>;
+
+/**
+ * @brief Проверяет, попадают ли сообщения уровня level в сборку.
+ */
+constexpr bool isLogLevelCompiled(LogLevel level) {
+    return level != LogLevel::Off && level >= COMPILED_LOG_LEVEL;
+}
+
+/**
+ * @brief Назначает приёмник категории; пустой приёмник отключает её.
+ */
+void setLogSink(LogCategory category, LogSink sink);
+
+/**
+ * @brief Возвращает приёмник, печатающий "[уровень] [категория] сообщение" в std::cerr.
+ */
+LogSink stderrLogSink();
+
+/**
+ * @brief Возвращает имя уровня ("WARNING").
+ */
+const char* logLevelName(LogLevel level);
+
+/**
+ * @brief Возвращает имя категории ("io").
+ */
+const char* logCategoryName(LogCategory category);
+
+namespace detail {
+    bool hasLogSink(LogCategory category);
+    void writeLog(LogLevel level, LogCategory category, std::string_view message);
+}
+
+/**
+ * @brief Записывает сообщение, собранное из частей через operator<<.
+ *
+ * @tparam Level Уровень сообщения; ниже COMPILED_LOG_LEVEL вызов не компилируется в код
+ */
+template <LogLevel Level, typename... Parts>
+void logMessage(LogCategory category, const Parts&... parts) {
+    if constexpr (isLogLevelCompiled(Level)) {
+        if (!detail::hasLogSink(category)) return;
+        std::ostringstream message;
+        (message << ... << parts);
+        detail::writeLog(Level, category, message.view());
+    }
+}
+
+#endif // LOGGING_HPP
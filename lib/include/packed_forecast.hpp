@@ -0,0 +1,222 @@
+/**
+ * @file packed_forecast.hpp
+ * @brief Компактная 16-байтная запись PackedWeatherDay и хранилище PackedForecast на её основе.
+ *
+ * WeatherDay занимает 40 байт: три uint32_t даты, три int температуры,
+ * перечисление и double осадков. Для реальных значений хватает меньшего:
+ * год помещается в int16_t, температуры — в int16_t, осадки хранятся в
+ * фиксированной точке (сотые доли) в uint32_t. Запись занимает 16 байт, так
+ * что в строку кэша попадает 4 дня вместо полутора, а сканирующие запросы
+ * читают в 2,5 раза меньше памяти.
+ *
+ * Преобразование без потерь: unpack(pack(day)) совпадает с day поле в поле.
+ * Дни, которые нельзя представить точно (температура выше 32767, осадки
+ * не кратны 0,01 или больше 42 949 672,95, явление вне Phenomen), не
+ * упаковываются — tryPack возвращает WeatherError::NotRepresentable.
+ */
+
+#ifndef PACKED_FORECAST_HPP
+#define PACKED_FORECAST_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <span>
+#include <vector>
+
+#include "date.hpp"
+#include "weather_day.hpp"
+#include "forecast.hpp"
+#include "weather_error.hpp"
+
+/**
+ * @struct PackedWeatherDay
+ * @brief Прогноз на один день в упакованном виде (16 байт).
+ *
+ * Методы для запросов (dateKey, averageTempOfDay, getPhenomen) работают
+ * прямо с упакованными полями, не восстанавливая WeatherDay.
+ */
+struct PackedWeatherDay {
+    uint32_t precipitation; ///< Осадки в сотых долях
+    int16_t year;           ///< Год
+    int16_t morning;        ///< Температура утром
+    int16_t noon;           ///< Температура днём
+    int16_t evening;        ///< Температура вечером
+    uint8_t day;            ///< День месяца
+    uint8_t month;          ///< Месяц
+    uint8_t phenomen;       ///< Значение Phenomen
+    uint8_t reserved;       ///< Выравнивание, заполняется нулём
+
+    /**
+     * @brief Упаковывает день без исключений.
+     *
+     * @param source Исходный день
+     * @return Упакованная запись или WeatherError::NotRepresentable, если день нельзя упаковать без потерь
+     */
+    static Expected<PackedWeatherDay> tryPack(const WeatherDay& source);
+
+    /**
+     * @brief Упаковывает день.
+     *
+     * @param source Исходный день
+     * @return Упакованная запись
+     * @throws std::invalid_argument если день нельзя упаковать без потерь
+     */
+    static PackedWeatherDay pack(const WeatherDay& source);
+
+    /**
+     * @brief Восстанавливает WeatherDay (точную копию упакованного дня).
+     */
+    WeatherDay unpack() const;
+
+    /**
+     * @brief Возвращает дату записи.
+     */
+    Date getDate() const;
+
+    /**
+     * @brief Ключ для сравнения дат: порядок ключей совпадает с порядком Date.
+     */
+    int32_t dateKey() const {
+        return static_cast<int32_t>(static_cast<uint32_t>(year) << 16 | uint32_t{month} << 8 | day);
+    }
+
+    /**
+     * @brief Средняя температура дня, как WeatherDay::averageTempOfDay().
+     */
+    int averageTempOfDay() const {
+        return (morning + noon + evening) / 3;
+    }
+
+    /**
+     * @brief Возвращает погодное явление дня.
+     */
+    Phenomen getPhenomen() const {
+        return static_cast<Phenomen>(phenomen);
+    }
+};
+
+static_assert(sizeof(PackedWeatherDay) == 16);
+
+/**
+ * @brief Ключ для сравнения дат, совместимый с PackedWeatherDay::dateKey().
+ */
+int32_t packedDateKey(const Date& date);
+
+/**
+ * @class PackedForecast
+ * @brief Хранилище прогнозов в упакованном виде для сканирующих запросов.
+ *
+ * Дни хранятся одним массивом PackedWeatherDay. Доступ по индексу возвращает
+ * WeatherDay по значению (восстановленный из записи), запросы сканируют
+ * упакованные записи и распаковывают только результат. Семантика запросов
+ * совпадает с одноимёнными методами Forecast.
+ */
+class PackedForecast {
+private:
+    std::vector<PackedWeatherDay> days; ///< Упакованные дни в порядке добавления
+
+public:
+    /**
+     * @brief Создаёт пустое хранилище.
+     */
+    PackedForecast() = default;
+
+    /**
+     * @brief Упаковывает все дни обычного Forecast.
+     *
+     * @param forecast Исходный прогноз
+     * @throws std::invalid_argument если какой-либо день нельзя упаковать без потерь
+     */
+    explicit PackedForecast(const Forecast& forecast);
+
+    /**
+     * @brief Добавляет день в конец.
+     *
+     * @param new_day Добавляемый прогноз
+     * @return Ссылка на *this
+     * @throws std::invalid_argument если день нельзя упаковать без потерь
+     */
+    PackedForecast& operator+=(const WeatherDay& new_day);
+
+    /**
+     * @brief Добавляет день в конец без исключений.
+     *
+     * @param new_day Добавляемый прогноз
+     * @return WeatherError::NotRepresentable, если день нельзя упаковать; хранилище при этом не меняется
+     */
+    Expected<void> tryAppend(const WeatherDay& new_day);
+
+    /**
+     * @brief Резервирует место под заданное количество дней.
+     */
+    void reserve(size_t new_capacity);
+
+    /**
+     * @brief Возвращает день по индексу.
+     *
+     * @param index Индекс (должен быть < getCount())
+     * @return Восстановленный WeatherDay
+     * @throws std::out_of_range если index >= getCount()
+     */
+    WeatherDay operator[](size_t index) const;
+
+    /**
+     * @brief Возвращает количество дней.
+     */
+    size_t getCount() const;
+
+    /**
+     * @brief Возвращает упакованные записи только для чтения.
+     */
+    std::span<const PackedWeatherDay> records() const;
+
+    /**
+     * @brief Возвращает объём памяти, занятой записями (по ёмкости массива), в байтах.
+     */
+    size_t memoryBytes() const;
+
+    /**
+     * @brief Находит самый холодный день в диапазоне (from, to).
+     * @param from Начальная дата (не включается)
+     * @param to   Конечная дата (не включается)
+     * @return Первый день с минимальной средней температурой
+     * @throws std::invalid_argument если хранилище пусто
+     * @throws std::runtime_error если в диапазоне нет дней
+     */
+    WeatherDay findColdestDay(const Date& from, const Date& to) const;
+
+    /**
+     * @brief Находит ближайший солнечный день после заданной даты.
+     * @param today Дата, после которой искать
+     * @return Первый солнечный день с минимальной датой
+     * @throws std::invalid_argument если хранилище пусто
+     * @throws std::runtime_error если подходящий день не найден
+     */
+    WeatherDay findNextSunnyDay(const Date& today) const;
+
+    /**
+     * @brief Возвращает все прогнозы для указанного месяца, упорядоченные по дате.
+     * @param month Номер месяца (1–12)
+     * @return Новый объект Forecast
+     * @throws std::invalid_argument если хранилище пусто или month вне [1,12]
+     * @throws std::runtime_error если в указанном месяце нет прогнозов
+     */
+    Forecast giveAllDaysOfMonth(size_t month) const;
+
+    /**
+     * @brief Распаковывает все дни в непрерывный Forecast.
+     * @return Новый объект Forecast
+     */
+    Forecast toForecast() const;
+
+    /**
+     * @brief Потоковый оператор вывода (в том же формате, что и у Forecast).
+     * @param os  Выходной поток
+     * @param obj Объект PackedForecast
+     * @return Ссылка на выходной поток
+     */
+    friend std::ostream& operator<<(std::ostream& os, const PackedForecast& obj);
+};
+
+#endif // PACKED_FORECAST_HPP
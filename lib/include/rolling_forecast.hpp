@@ -0,0 +1,134 @@
+/**
+ * @file rolling_forecast.hpp
+ * @brief Определение класса RollingForecast — скользящее окно последних N дней на кольцевом буфере.
+ *
+ * Для «живых» панелей нужны только последние N дней станции. С обычным
+ * Forecast каждый новый день сопровождается удалением самого старого.
+ * RollingForecast хранит дни в кольцевом буфере фиксированной ёмкости:
+ * добавление в заполненное окно перезаписывает самый старый день за O(1),
+ * а запросы проходят две непрерывные части буфера (до и после точки
+ * заворота) без копирования.
+ */
+
+#ifndef ROLLING_FORECAST_HPP
+#define ROLLING_FORECAST_HPP
+
+#include <array>
+#include <cstddef>
+#include <iostream>
+#include <span>
+#include <vector>
+
+#include "weather_day.hpp"
+#include "forecast.hpp"
+
+/**
+ * @class RollingForecast
+ * @brief Окно из не более чем capacity последних добавленных прогнозов.
+ *
+ * Индекс 0 соответствует самому старому дню в окне, getCount() - 1 — самому новому.
+ *
+ * @warning Ссылки на элементы становятся недействительными, когда день вытесняется из окна.
+ */
+class RollingForecast {
+private:
+    std::vector<WeatherDay> days;   ///< Кольцевой буфер размером capacity
+    size_t head;                    ///< Позиция самого старого дня
+    size_t count;                   ///< Текущее количество дней в окне
+
+public:
+    /**
+     * @brief Создаёт пустое окно заданной ёмкости.
+     *
+     * @param capacity Максимальное количество дней в окне (> 0)
+     * @throws std::invalid_argument если capacity == 0
+     */
+    explicit RollingForecast(size_t capacity);
+
+    /**
+     * @brief Добавляет день в окно.
+     * Если окно заполнено, самый старый день вытесняется за O(1).
+     * @param new_day Добавляемый прогноз
+     * @return Ссылка на *this
+     */
+    RollingForecast& operator+=(const WeatherDay& new_day);
+
+    /**
+     * @brief Доступ к прогнозу по индексу (0 — самый старый).
+     * @param index Индекс (должен быть < getCount())
+     * @return Константная ссылка на WeatherDay
+     * @throws std::out_of_range если index >= getCount()
+     */
+    const WeatherDay& operator[](size_t index) const;
+
+    /**
+     * @brief Возвращает количество дней в окне.
+     */
+    size_t getCount() const;
+
+    /**
+     * @brief Возвращает ёмкость окна.
+     */
+    size_t getCapacity() const;
+
+    /**
+     * @brief Проверяет, заполнено ли окно.
+     */
+    bool isFull() const;
+
+    /**
+     * @brief Удаляет все дни, ёмкость сохраняется.
+     */
+    void clear();
+
+    /**
+     * @brief Возвращает содержимое окна в виде двух непрерывных частей.
+     * Первая часть начинается с самого старого дня; вторая пуста, если окно не заворачивается.
+     * @return Части буфера в порядке добавления
+     */
+    std::array<std::span<const WeatherDay>, 2> segments() const;
+
+    /**
+     * @brief Находит самый холодный день в диапазоне (from, to).
+     * @param from Начальная дата (не включается)
+     * @param to   Конечная дата (не включается)
+     * @return Копия самого холодного WeatherDay
+     * @throws std::invalid_argument если окно пусто
+     * @throws std::runtime_error если в диапазоне нет дней
+     */
+    WeatherDay findColdestDay(const Date& from, const Date& to) const;
+
+    /**
+     * @brief Находит ближайший солнечный день после заданной даты.
+     * @param today Дата, после которой искать
+     * @return Копия первого солнечного дня с минимальной датой
+     * @throws std::invalid_argument если окно пусто
+     * @throws std::runtime_error если подходящий день не найден
+     */
+    WeatherDay findNextSunnyDay(const Date& today) const;
+
+    /**
+     * @brief Возвращает все прогнозы для указанного месяца, упорядоченные по дате.
+     * @param month Номер месяца (1–12)
+     * @return Новый объект Forecast
+     * @throws std::invalid_argument если окно пусто или month вне [1,12]
+     * @throws std::runtime_error если в указанном месяце нет прогнозов
+     */
+    Forecast giveAllDaysOfMonth(size_t month) const;
+
+    /**
+     * @brief Копирует дни окна в непрерывный Forecast в порядке добавления.
+     * @return Новый объект Forecast
+     */
+    Forecast toForecast() const;
+
+    /**
+     * @brief Потоковый оператор вывода (в том же формате, что и у Forecast).
+     * @param os  Выходной поток
+     * @param obj Объект RollingForecast
+     * @return Ссылка на выходной поток
+     */
+    friend std::ostream& operator<<(std::ostream& os, const RollingForecast& obj);
+};
+
+#endif // ROLLING_FORECAST_HPP
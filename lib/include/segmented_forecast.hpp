@@ -0,0 +1,194 @@
+/**
+ * @file segmented_forecast.hpp
+ * @brief Определение класса SegmentedForecast — хранилище прогнозов из блоков фиксированного размера.
+ *
+ * В отличие от Forecast, который при переполнении выделяет новый непрерывный
+ * массив и копирует в него все данные, SegmentedForecast наращивает память
+ * блоками (по умолчанию по 64K записей). Добавление никогда не перемещает уже
+ * сохранённые дни, поэтому нет ни двукратных всплесков памяти, ни пауз на копирование.
+ */
+
+#ifndef SEGMENTED_FORECAST_HPP
+#define SEGMENTED_FORECAST_HPP
+
+#include <cstddef>
+#include <iostream>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "weather_day.hpp"
+#include "forecast.hpp"
+
+/**
+ * @class SegmentedForecast
+ * @brief Контейнер прогнозов с блочным (сегментированным) хранением.
+ *
+ * Поддерживает:
+ * - добавление в конец за O(1) без перемещения существующих данных,
+ * - произвольный доступ по индексу за O(1) (сдвиг и маска),
+ * - поблочное сканирование запросами из forecast_queries.hpp,
+ * - удаление некорректных прогнозов и преобразование в Forecast.
+ *
+ * @note Размер блока должен быть степенью двойки.
+ * @warning Ссылки на элементы остаются действительными при добавлении новых дней.
+ */
+class SegmentedForecast {
+public:
+    static constexpr size_t DEFAULT_CHUNK_SIZE = 65536; ///< Размер блока по умолчанию (записей)
+
+private:
+    std::vector<std::unique_ptr<WeatherDay[]>> chunks; ///< Блоки фиксированного размера
+    size_t chunk_size;   ///< Количество записей в одном блоке
+    size_t chunk_shift;  ///< log2(chunk_size) для перевода индекса в номер блока
+    size_t count;        ///< Текущее количество элементов
+
+public:
+    /**
+     * @brief Конструктор с заданным размером блока.
+     *
+     * @param new_chunk_size Количество записей в блоке (степень двойки, > 0)
+     * @throws std::invalid_argument если размер блока не является степенью двойки
+     */
+    explicit SegmentedForecast(size_t new_chunk_size = DEFAULT_CHUNK_SIZE);
+
+    /**
+     * @brief Создаёт сегментированную копию обычного Forecast.
+     *
+     * @param forecast Исходный прогноз
+     * @param new_chunk_size Количество записей в блоке (степень двойки, > 0)
+     * @throws std::invalid_argument если размер блока не является степенью двойки
+     */
+    explicit SegmentedForecast(const Forecast& forecast, size_t new_chunk_size = DEFAULT_CHUNK_SIZE);
+
+    /**
+     * @brief Конструктор копирования (глубокое копирование блоков).
+     * @param other Исходный объект
+     */
+    SegmentedForecast(const SegmentedForecast& other);
+
+    /**
+     * @brief Конструктор перемещения. Блоки не копируются, `other` становится пустым.
+     * @param other Источник (rvalue)
+     */
+    SegmentedForecast(SegmentedForecast&& other) noexcept;
+
+    /**
+     * @brief Оператор копирующего присваивания.
+     * @param other Источник
+     * @return Ссылка на *this
+     */
+    SegmentedForecast& operator=(const SegmentedForecast& other);
+
+    /**
+     * @brief Оператор перемещающего присваивания.
+     * @param other Источник (rvalue)
+     * @return Ссылка на *this
+     */
+    SegmentedForecast& operator=(SegmentedForecast&& other) noexcept;
+
+    /**
+     * @brief Добавляет прогноз в конец.
+     *
+     * При заполнении последнего блока выделяет новый; существующие данные не перемещаются.
+     *
+     * @param new_day Добавляемый прогноз
+     * @return Ссылка на *this
+     */
+    SegmentedForecast& operator+=(const WeatherDay& new_day);
+
+    /**
+     * @brief Доступ к прогнозу по индексу.
+     *
+     * @param index Индекс (должен быть < getCount())
+     * @return Ссылка на WeatherDay
+     * @throws std::out_of_range если index >= getCount()
+     */
+    WeatherDay& operator[](size_t index);
+
+    /**
+     * @brief Доступ к прогнозу по индексу только для чтения.
+     *
+     * @param index Индекс (должен быть < getCount())
+     * @return Константная ссылка на WeatherDay
+     * @throws std::out_of_range если index >= getCount()
+     */
+    const WeatherDay& operator[](size_t index) const;
+
+    /**
+     * @brief Возвращает количество прогнозов.
+     */
+    size_t getCount() const;
+
+    /**
+     * @brief Возвращает размер блока в записях.
+     */
+    size_t getChunkSize() const;
+
+    /**
+     * @brief Возвращает количество выделенных блоков.
+     */
+    size_t getChunkCount() const;
+
+    /**
+     * @brief Возвращает заполненные части блоков для поблочного сканирования.
+     *
+     * @return Список непрерывных сегментов в порядке хранения
+     */
+    std::vector<std::span<const WeatherDay>> segments() const;
+
+    /**
+     * @brief Удаляет все некорректные прогнозы (check() == false).
+     *
+     * Сохраняет относительный порядок, освобождает ставшие пустыми блоки в конце.
+     */
+    void deleteAllErrors();
+
+    /**
+     * @brief Находит самый холодный день в диапазоне (from, to).
+     *
+     * @param from Начальная дата (не включается)
+     * @param to   Конечная дата (не включается)
+     * @return Копия самого холодного WeatherDay
+     * @throws std::invalid_argument если контейнер пуст
+     * @throws std::runtime_error если в диапазоне нет дней
+     */
+    WeatherDay findColdestDay(const Date& from, const Date& to) const;
+
+    /**
+     * @brief Находит ближайший солнечный день после заданной даты.
+     *
+     * @param today Дата, после которой искать
+     * @return Копия первого солнечного дня с минимальной датой
+     * @throws std::invalid_argument если контейнер пуст
+     * @throws std::runtime_error если подходящий день не найден
+     */
+    WeatherDay findNextSunnyDay(const Date& today) const;
+
+    /**
+     * @brief Возвращает все прогнозы для указанного месяца, упорядоченные по дате.
+     *
+     * @param month Номер месяца (1–12)
+     * @return Новый объект Forecast
+     * @throws std::invalid_argument если контейнер пуст или month вне [1,12]
+     * @throws std::runtime_error если в указанном месяце нет прогнозов
+     */
+    Forecast giveAllDaysOfMonth(size_t month) const;
+
+    /**
+     * @brief Копирует все прогнозы в непрерывный Forecast.
+     * @return Новый объект Forecast
+     */
+    Forecast toForecast() const;
+
+    /**
+     * @brief Потоковый оператор вывода (в том же формате, что и у Forecast).
+     *
+     * @param os  Выходной поток
+     * @param obj Объект SegmentedForecast
+     * @return Ссылка на выходной поток
+     */
+    friend std::ostream& operator<<(std::ostream& os, const SegmentedForecast& obj);
+};
+
+#endif // SEGMENTED_FORECAST_HPP
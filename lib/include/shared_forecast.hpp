@@ -0,0 +1,165 @@
+/**
+ * @file shared_forecast.hpp
+ * @brief Публикация прогноза в разделяемой памяти POSIX для чтения из нескольких процессов.
+ *
+ * Один процесс (SharedForecastPublisher) записывает Forecast в сегмент
+ * shm_open(), остальные (SharedForecastReader) отображают его только для
+ * чтения и выполняют запросы прямо по отображённой памяти. N читателей
+ * используют одну копию данных.
+ *
+ * Раскладка сегмента:
+ * - заголовок: магическое число, ёмкость, счётчик последовательности
+ *   (sequence) и количество дней в каждом из двух буферов;
+ * - два буфера одинаковой ёмкости, каждый хранит данные по столбцам
+ *   (осадки, год, месяц, день, средняя температура, температуры утром/днём/
+ *   вечером, явление), чтобы запрос читал только нужные ему столбцы.
+ *
+ * Протокол обновления (seqlock с двойной буферизацией):
+ * - k-я публикация пишет в буфер k % 2; перед записью sequence = 2k - 1,
+ *   после — 2k. Таким образом sequence / 2 — число завершённых публикаций.
+ * - Читатель берёт s = sequence, читает буфер (s / 2) % 2 и после запроса
+ *   проверяет, что sequence < s / 2 * 2 + 3, т.е. писатель не начал
+ *   перезаписывать этот буфер. Иначе запрос повторяется.
+ * - Пока писатель пишет в один буфер, читатели спокойно читают другой,
+ *   а новая версия становится видна целиком, одним сохранением sequence.
+ */
+
+#ifndef SHARED_FORECAST_HPP
+#define SHARED_FORECAST_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "date.hpp"
+#include "weather_day.hpp"
+#include "forecast.hpp"
+
+/**
+ * @class SharedForecastPublisher
+ * @brief Создаёт сегмент разделяемой памяти и публикует в него версии прогноза.
+ *
+ * Публикации из нескольких потоков должны сериализоваться вызывающим кодом.
+ * Деструктор удаляет имя сегмента (shm_unlink); уже открытые читатели
+ * продолжают видеть последнюю опубликованную версию.
+ */
+class SharedForecastPublisher {
+private:
+    std::string name;   ///< Имя сегмента
+    void* base;         ///< Начало отображения
+    size_t size;        ///< Размер отображения в байтах
+    size_t capacity;    ///< Максимальное количество дней в версии
+
+public:
+    /**
+     * @brief Создаёт (или пересоздаёт) сегмент с заданным именем.
+     *
+     * @param segment_name Имя сегмента в стиле shm_open ("/forecast")
+     * @param max_days     Максимальное количество дней в публикуемом прогнозе (> 0)
+     * @throws std::invalid_argument если max_days == 0
+     * @throws std::runtime_error если сегмент не удалось создать или отобразить
+     */
+    SharedForecastPublisher(const std::string& segment_name, size_t max_days);
+
+    /**
+     * @brief Отключает отображение и удаляет имя сегмента.
+     */
+    ~SharedForecastPublisher();
+
+    SharedForecastPublisher(const SharedForecastPublisher&) = delete;
+    SharedForecastPublisher& operator=(const SharedForecastPublisher&) = delete;
+
+    /**
+     * @brief Публикует новую версию прогноза.
+     *
+     * Записывает живые дни forecast в неактивный буфер и атомарно делает его текущим.
+     *
+     * @param forecast Публикуемый прогноз
+     * @throws std::invalid_argument если forecast.getCount() больше ёмкости сегмента
+     */
+    void publish(const Forecast& forecast);
+
+    /**
+     * @brief Возвращает число завершённых публикаций.
+     */
+    uint64_t getGeneration() const;
+
+    /**
+     * @brief Возвращает ёмкость сегмента в днях.
+     */
+    size_t getCapacity() const;
+};
+
+/**
+ * @class SharedForecastReader
+ * @brief Отображает опубликованный сегмент только для чтения и выполняет запросы на месте.
+ *
+ * Запросы не копируют данные: проход идёт по столбцам разделяемой памяти,
+ * в WeatherDay превращаются только найденные дни. Семантика запросов
+ * совпадает с одноимёнными методами Forecast.
+ */
+class SharedForecastReader {
+private:
+    void* base;         ///< Начало отображения
+    size_t size;        ///< Размер отображения в байтах
+
+public:
+    /**
+     * @brief Открывает существующий сегмент.
+     *
+     * @param segment_name Имя сегмента, переданное издателю
+     * @throws std::runtime_error если сегмент не найден, не отображается или имеет неверный формат
+     */
+    explicit SharedForecastReader(const std::string& segment_name);
+
+    /**
+     * @brief Отключает отображение.
+     */
+    ~SharedForecastReader();
+
+    SharedForecastReader(const SharedForecastReader&) = delete;
+    SharedForecastReader& operator=(const SharedForecastReader&) = delete;
+
+    /**
+     * @brief Возвращает число завершённых публикаций (0 — ещё ничего не опубликовано).
+     */
+    uint64_t getGeneration() const;
+
+    /**
+     * @brief Возвращает количество дней в текущей версии.
+     */
+    size_t getCount() const;
+
+    /**
+     * @brief Возвращает день текущей версии по индексу.
+     *
+     * @throws std::out_of_range если index >= getCount()
+     */
+    WeatherDay at(size_t index) const;
+
+    /**
+     * @brief Находит самый холодный день в диапазоне дат (from, to).
+     *
+     * @throws std::invalid_argument если версия пуста
+     * @throws std::runtime_error если в диапазоне нет дней
+     */
+    WeatherDay findColdestDay(const Date& from, const Date& to) const;
+
+    /**
+     * @brief Находит ближайший солнечный день после заданной даты.
+     *
+     * @throws std::invalid_argument если версия пуста
+     * @throws std::runtime_error если подходящий день не найден
+     */
+    WeatherDay findNextSunnyDay(const Date& today) const;
+
+    /**
+     * @brief Возвращает все дни указанного месяца, упорядоченные по дате.
+     *
+     * @throws std::invalid_argument если версия пуста или month вне [1,12]
+     * @throws std::runtime_error если в указанном месяце нет прогнозов
+     */
+    Forecast giveAllDaysOfMonth(size_t month) const;
+};
+
+#endif // SHARED_FORECAST_HPP
@@ -0,0 +1,123 @@
+/**
+ * @file spsc_queue.hpp
+ * @brief Определение шаблона SpscQueue — ограниченной очереди без блокировок для одного писателя и одного читателя.
+ *
+ * Используется для передачи пачек прогнозов от потока разбора к потоку,
+ * владеющему Forecast, без мьютекса на каждую запись.
+ */
+
+#ifndef SPSC_QUEUE_HPP
+#define SPSC_QUEUE_HPP
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+/**
+ * @class SpscQueue
+ * @brief Кольцевой буфер фиксированной ёмкости для ровно одного производителя и одного потребителя.
+ *
+ * Индексы производителя и потребителя лежат в разных кэш-линиях, рядом с каждым —
+ * локальная копия индекса другой стороны. Поэтому атомарные чтения чужого
+ * индекса нужны только когда очередь кажется полной (или пустой).
+ *
+ * @tparam T Тип элемента (обычно пачка std::vector<WeatherDay>)
+ * @warning tryPush() можно вызывать только из одного потока, tryPop()/drain() — только из другого.
+ */
+template <typename T>
+class SpscQueue {
+private:
+    static constexpr size_t CACHE_LINE = 64; ///< Размер кэш-линии для выравнивания индексов
+
+    std::unique_ptr<T[]> slots; ///< Ячейки кольцевого буфера
+    size_t capacity;            ///< Ёмкость (степень двойки)
+
+    alignas(CACHE_LINE) std::atomic<size_t> head; ///< Следующая ячейка для чтения (пишет потребитель)
+    size_t cached_tail;                           ///< Последний виденный потребителем tail
+
+    alignas(CACHE_LINE) std::atomic<size_t> tail; ///< Следующая ячейка для записи (пишет производитель)
+    size_t cached_head;                           ///< Последний виденный производителем head
+
+public:
+    /**
+     * @brief Конструктор.
+     *
+     * @param new_capacity Ёмкость очереди (степень двойки, > 0)
+     * @throws std::invalid_argument если ёмкость не является степенью двойки
+     */
+    explicit SpscQueue(size_t new_capacity): capacity(new_capacity), head(0), cached_tail(0), tail(0), cached_head(0) {
+        if (!std::has_single_bit(new_capacity)) throw std::invalid_argument("INVALID CAPACITY\n");
+        slots = std::make_unique<T[]>(new_capacity);
+    }
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    /**
+     * @brief Пытается поместить элемент в очередь (только поток производителя).
+     *
+     * @param item Элемент; перемещается только при успехе
+     * @return true, если элемент помещён; false, если очередь заполнена
+     */
+    bool tryPush(T&& item) {
+        size_t position = tail.load(std::memory_order_relaxed);
+        if (position - cached_head == capacity) {
+            cached_head = head.load(std::memory_order_acquire);
+            if (position - cached_head == capacity) return false;
+        }
+        slots[position & (capacity - 1)] = std::move(item);
+        tail.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Пытается извлечь элемент из очереди (только поток потребителя).
+     *
+     * @param item Куда переместить извлечённый элемент
+     * @return true, если элемент извлечён; false, если очередь пуста
+     */
+    bool tryPop(T& item) {
+        size_t position = head.load(std::memory_order_relaxed);
+        if (position == cached_tail) {
+            cached_tail = tail.load(std::memory_order_acquire);
+            if (position == cached_tail) return false;
+        }
+        item = std::move(slots[position & (capacity - 1)]);
+        head.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Извлекает все доступные сейчас элементы и передаёт их в sink (только поток потребителя).
+     *
+     * Пример слива пачек в Forecast:
+     * @code
+     * queue.drain([&forecast](std::vector<WeatherDay>& batch) { forecast.append(batch); });
+     * @endcode
+     *
+     * @param sink Вызывается для каждого элемента с неконстантной ссылкой на него
+     * @return Количество извлечённых элементов
+     */
+    template <typename Sink>
+    size_t drain(Sink&& sink) {
+        size_t drained = 0;
+        T item;
+        while (tryPop(item)) {
+            sink(item);
+            drained++;
+        }
+        return drained;
+    }
+
+    /**
+     * @brief Возвращает ёмкость очереди.
+     */
+    size_t getCapacity() const {
+        return capacity;
+    }
+};
+
+#endif // SPSC_QUEUE_HPP
@@ -0,0 +1,131 @@
+/**
+ * @file thread_pool.hpp
+ * @brief Определение класса ThreadPool — пула потоков с перехватом работы (work stealing).
+ *
+ * У каждого рабочего потока своя очередь задач. Поток берёт задачи из своей
+ * очереди с конца (LIFO, тёплый кэш), а при её опустошении перехватывает
+ * самые старые задачи из начала чужих очередей (FIFO).
+ */
+
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @class ThreadPool
+ * @brief Планировщик задач с очередью на каждый рабочий поток и перехватом работы.
+ *
+ * - Задача, отправленная из рабочего потока, попадает в его собственную очередь.
+ * - Задачи из внешних потоков распределяются по очередям по кругу.
+ * - Свободный поток сначала проверяет свою очередь, затем перехватывает из чужих,
+ *   и только после этого засыпает на условной переменной.
+ *
+ * @warning Задачи, переданные через submit(), не должны выбрасывать исключений;
+ *          для задач с результатом или исключением используйте async().
+ */
+class ThreadPool {
+private:
+    /**
+     * @brief Очередь задач одного рабочего потока.
+     */
+    struct alignas(64) Worker {
+        std::mutex lock;                          ///< Защищает очередь задач
+        std::deque<std::function<void()>> tasks;  ///< Задачи потока
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers; ///< Очереди рабочих потоков
+    std::vector<std::thread> threads;             ///< Рабочие потоки
+    std::mutex sleep_lock;                        ///< Защищает засыпание и флаг остановки
+    std::condition_variable wake;                 ///< Будит спящие потоки при появлении задач
+    std::atomic<size_t> pending;                  ///< Количество поставленных, но не взятых задач
+    std::atomic<size_t> next_queue;               ///< Счётчик кругового распределения внешних задач
+    std::atomic<uint64_t> steals;                 ///< Количество успешных перехватов
+    bool stopping;                                ///< Пул останавливается (под sleep_lock)
+
+    /**
+     * @brief Берёт задачу с конца собственной очереди потока.
+     */
+    bool popLocal(size_t index, std::function<void()>& task);
+
+    /**
+     * @brief Перехватывает задачу из начала чужой очереди.
+     *
+     * @param thief Индекс перехватывающего потока (его очередь пропускается) или workers.size() для внешнего потока
+     */
+    bool steal(size_t thief, std::function<void()>& task);
+
+    /**
+     * @brief Основной цикл рабочего потока.
+     */
+    void workerLoop(size_t index);
+
+public:
+    /**
+     * @brief Конструктор: запускает рабочие потоки.
+     *
+     * @param thread_count Количество рабочих потоков (0 — по числу аппаратных потоков)
+     */
+    explicit ThreadPool(size_t thread_count = 0);
+
+    /**
+     * @brief Деструктор: дожидается выполнения всех поставленных задач и останавливает потоки.
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief Ставит задачу в очередь.
+     * @param task Задача (не должна выбрасывать исключений)
+     */
+    void submit(std::function<void()> task);
+
+    /**
+     * @brief Ставит задачу с результатом в очередь.
+     *
+     * @param function Вызываемый объект без аргументов
+     * @return std::future с результатом или исключением задачи
+     */
+    template <typename Function>
+    std::future<std::invoke_result_t<Function>> async(Function&& function) {
+        using Result = std::invoke_result_t<Function>;
+        auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<Function>(function));
+        std::future<Result> result = task->get_future();
+        submit([task]() { (*task)(); });
+        return result;
+    }
+
+    /**
+     * @brief Выполняет одну ожидающую задачу в вызывающем потоке, если она есть.
+     *
+     * Позволяет ожидающему потоку помогать пулу вместо простоя.
+     *
+     * @return true, если задача была выполнена
+     */
+    bool tryRunOne();
+
+    /**
+     * @brief Возвращает количество рабочих потоков.
+     */
+    size_t getThreadCount() const;
+
+    /**
+     * @brief Возвращает количество успешных перехватов задач.
+     */
+    uint64_t getStealCount() const;
+};
+
+#endif // THREAD_POOL_HPP
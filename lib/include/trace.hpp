@@ -0,0 +1,82 @@
+/**
+ * @file trace.hpp
+ * @brief Трассировка тяжёлых операций библиотеки в формате Chrome trace-event JSON.
+ *
+ * TraceSpan отмечает интервал от создания до разрушения. Пока трассировка
+ * выключена, конструктор только читает атомарный флаг. Включённая трассировка
+ * пишет события в буфер текущего потока, а writeTrace() собирает буферы
+ * всех потоков в JSON, который открывается в Perfetto (ui.perfetto.dev)
+ * или chrome://tracing.
+ *
+ * Имена и категории событий должны быть строковыми литералами: буферы
+ * хранят только указатели.
+ */
+
+#ifndef TRACE_HPP
+#define TRACE_HPP
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+/**
+ * @class TraceSpan
+ * @brief Интервал трассировки в области видимости.
+ */
+class TraceSpan {
+private:
+    const char* name;       ///< Имя события
+    const char* category;   ///< Категория события
+    int64_t start;          ///< Начало в наносекундах от старта процесса, -1 — трассировка выключена
+
+public:
+    /**
+     * @brief Начинает интервал, если трассировка включена.
+     *
+     * @param span_name     Имя события (строковый литерал)
+     * @param span_category Категория события (строковый литерал)
+     */
+    explicit TraceSpan(const char* span_name, const char* span_category = "forecast");
+
+    /**
+     * @brief Завершает интервал и записывает событие в буфер потока.
+     */
+    ~TraceSpan();
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+};
+
+/**
+ * @brief Включает запись событий.
+ */
+void startTracing();
+
+/**
+ * @brief Выключает запись событий; уже записанные события сохраняются.
+ */
+void stopTracing();
+
+/**
+ * @brief Проверяет, включена ли запись событий.
+ */
+bool isTracing();
+
+/**
+ * @brief Удаляет записанные события всех потоков.
+ */
+void clearTrace();
+
+/**
+ * @brief Записывает события всех потоков как Chrome trace-event JSON.
+ */
+void writeTrace(std::ostream& out);
+
+/**
+ * @brief Записывает события всех потоков в файл.
+ *
+ * @return false, если файл не удалось открыть или записать
+ */
+bool writeTraceFile(const std::string& filename);
+
+#endif // TRACE_HPP
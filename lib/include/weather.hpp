@@ -13,6 +13,8 @@
 #include <iostream>
 #include <stdexcept>
 
+#include "weather_error.hpp"
+
 /**
  * @enum Phenomen
  * @brief Перечисление основных типов погодных явлений.
@@ -60,6 +62,22 @@ public:
      */
     void setTemperature(int new_temperature);
 
+    /**
+     * @brief Устанавливает температуру без исключений.
+     *
+     * @param new_temperature Новая температура в градусах Цельсия.
+     * @return WeatherError::InvalidTemperature, если температура ниже −273°C; при ошибке значение не меняется
+     */
+    Expected<void> trySetTemperature(int new_temperature);
+
+    /**
+     * @brief Создаёт погоду с заданной температурой без исключений.
+     *
+     * @param temperature Температура в градусах Цельсия.
+     * @return Weather или WeatherError::InvalidTemperature
+     */
+    static Expected<Weather> tryMake(int temperature);
+
     /**
      * @brief Возвращает текущую температуру.
      *
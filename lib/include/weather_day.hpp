@@ -92,6 +92,16 @@ public:
      */
     WeatherDay(Date dt, double newprecipitation, PartsOfDay newparts, int phenomen);
 
+    /**
+     * @brief Создаёт прогноз с автоматическим определением явления без исключений.
+     *
+     * @param dt               Дата
+     * @param newprecipitation Количество осадков (≥ 0)
+     * @param parts            Погода по частям дня
+     * @return WeatherDay или WeatherError::InvalidPrecipitation
+     */
+    static Expected<WeatherDay> tryMake(Date dt, double newprecipitation, PartsOfDay parts);
+
     /**
      * @brief Устанавливает количество осадков.
      * @param new_precipitation Новое значение осадков (должно быть ≥ 0)
@@ -99,6 +109,12 @@ public:
      */
     void setPrecipitation(double new_precipitation);
 
+    /**
+     * @brief Устанавливает количество осадков без исключений.
+     * @return WeatherError::InvalidPrecipitation, если значение < 0; при ошибке значение не меняется
+     */
+    Expected<void> trySetPrecipitation(double new_precipitation);
+
     /**
      * @brief Устанавливает погодное явление.
      * @param newphenomen Новое значение из перечисления Phenomen.
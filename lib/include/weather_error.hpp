@@ -0,0 +1,56 @@
+/**
+ * @file weather_error.hpp
+ * @brief Коды ошибок для невыбрасывающего API библиотеки (std::expected).
+ *
+ * Методы с префиксом try (Date::tryMake, Weather::trySetTemperature,
+ * Forecast::tryFindColdestDay и т.д.) возвращают Expected<T> вместо
+ * выбрасывания исключения. Это нужно на горячих путях, где некорректные
+ * данные — обычное дело (разбор «грязных» источников), и раскрутка стека
+ * обходится дороже самой проверки. Выбрасывающие методы реализованы поверх
+ * try-вариантов и выбрасывают те же исключения, что и раньше.
+ */
+
+#ifndef WEATHER_ERROR_HPP
+#define WEATHER_ERROR_HPP
+
+#include <expected>
+
+/**
+ * @enum WeatherError
+ * @brief Причина отказа невыбрасывающей операции.
+ */
+enum class WeatherError {
+    InvalidDay = 1,        ///< День вне [0, 31]
+    InvalidMonth,          ///< Месяц вне допустимого диапазона
+    InvalidYear,           ///< Год вне [-999, 9999]
+    InvalidTemperature,    ///< Температура ниже −273°C
+    InvalidPrecipitation,  ///< Отрицательные осадки
+    InvalidCapacity,       ///< Нулевая ёмкость контейнера
+    InvalidIndex,          ///< Индекс за пределами контейнера
+    EmptyData,             ///< Контейнер пуст
+    NotFound,              ///< Подходящих записей нет
+    ParseError,            ///< Строка не соответствует формату
+    NotRepresentable       ///< Значение не помещается в компактный формат без потерь
+};
+
+/**
+ * @brief Результат невыбрасывающей операции: значение или код ошибки.
+ */
+template <typename T>
+using Expected = std::expected<T, WeatherError>;
+
+/**
+ * @brief Возвращает краткий текст ошибки.
+ *
+ * Для ошибок проверки значений (InvalidDay … InvalidPrecipitation) текст
+ * совпадает с сообщением исключения соответствующего сеттера. Остальные
+ * коды — собственные короткие метки: выбрасывающие методы для тех же
+ * ситуаций сообщают подробнее (например, «No day found in the given range»
+ * вместо NotFound), а у ParseError выбрасывающего аналога нет.
+ *
+ * @param error Код ошибки
+ * @return Строка со статическим временем жизни
+ */
+const char* errorMessage(WeatherError error);
+
+#endif // WEATHER_ERROR_HPP
@@ -2,9 +2,28 @@
 #define LAB2_WEATHER_LIB_H
 
 #include "weather.hpp"
+#include "weather_error.hpp"
 #include "date.hpp"
 #include "parts_of_day.hpp"
 #include "weather_day.hpp"
 #include "forecast.hpp"
+#include "forecast_queries.hpp"
+#include "segmented_forecast.hpp"
+#include "packed_forecast.hpp"
+#include "rolling_forecast.hpp"
+#include "concurrent_forecast.hpp"
+#include "spsc_queue.hpp"
+#include "forecast_store.hpp"
+#include "thread_pool.hpp"
+#include "batch_query.hpp"
+#include "forecast_io.hpp"
+#include "forecast_archive.hpp"
+#include "async_task.hpp"
+#include "async_forecast.hpp"
+#include "shared_forecast.hpp"
+#include "forecast_generator.hpp"
+#include "forecast_metrics.hpp"
+#include "trace.hpp"
+#include "logging.hpp"
 
 #endif
\ No newline at end of file
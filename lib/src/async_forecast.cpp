@@ -0,0 +1,88 @@
+#include "async_forecast.hpp"
+
+#include <fstream>
+
+#include "forecast_io.hpp"
+
+using namespace std;
+
+namespace {
+    constexpr size_t SCAN_CHUNK = 4096; ///< Количество дней между проверками отмены
+
+    void throwIfStopped(const stop_token& token) {
+        if (token.stop_requested()) throw OperationCancelled();
+    }
+}
+
+ThreadPool& asyncExecutor() {
+    static ThreadPool pool;
+    return pool;
+}
+
+Task<Forecast> importForecastAsync(string filename, stop_token token) {
+    co_await schedule(asyncExecutor());
+    ifstream file(filename);
+    if (!file.is_open()) throw runtime_error("CANNOT OPEN FILE\n");
+    Forecast result;
+    importForecast(file, result, token);
+    throwIfStopped(token);
+    if (file.bad()) throw runtime_error("READ ERROR\n");
+    co_return result;
+}
+
+Task<Forecast> sortAsync(Forecast forecast, stop_token token) {
+    co_await schedule(asyncExecutor());
+    throwIfStopped(token);
+    forecast.sortDaysByData();
+    throwIfStopped(token);
+    co_return forecast;
+}
+
+Task<Forecast> mergeAsync(Forecast first, Forecast second, stop_token token) {
+    co_await schedule(asyncExecutor());
+    throwIfStopped(token);
+    first.sortDaysByData();
+    throwIfStopped(token);
+    second.sortDaysByData();
+    throwIfStopped(token);
+    co_return first.mergeSorted(second);
+}
+
+Task<Forecast> giveAllDaysOfMonthAsync(Forecast forecast, size_t month, stop_token token) {
+    co_await schedule(asyncExecutor());
+    if (forecast.getCount() == 0) throw invalid_argument("DATA IS EMPTY\n");
+    if (month > 12 || month == 0) throw invalid_argument("INVALID MONTH\n");
+    // Без надгробий индексы совпадают с позициями в буфере
+    forecast.compact();
+    Forecast result;
+    for (size_t begin = 0; begin < forecast.getCount(); begin += SCAN_CHUNK) {
+        throwIfStopped(token);
+        size_t end = min(begin + SCAN_CHUNK, forecast.getCount());
+        for (size_t i = begin; i < end; i++) {
+            const WeatherDay& day = as_const(forecast)[i];
+            if (day.getDate().getMonth() == month) result += day;
+        }
+    }
+    if (result.getCount() == 0) throw runtime_error("There is no weather forecast for this month.\n");
+    throwIfStopped(token);
+    result.sortDaysByData();
+    co_return result;
+}
+
+Task<WeatherDay> findColdestDayAsync(Forecast forecast, Date from, Date to, stop_token token) {
+    co_await schedule(asyncExecutor());
+    if (forecast.getCount() == 0) throw invalid_argument("DATA IS EMPTY\n");
+    forecast.compact();
+    const WeatherDay* coldest = nullptr;
+    for (size_t begin = 0; begin < forecast.getCount(); begin += SCAN_CHUNK) {
+        throwIfStopped(token);
+        size_t end = min(begin + SCAN_CHUNK, forecast.getCount());
+        for (size_t i = begin; i < end; i++) {
+            const WeatherDay& day = as_const(forecast)[i];
+            if (!(day.getDate() > from && day.getDate() < to)) continue;
+            if (coldest == nullptr || day.averageTempOfDay() < coldest->averageTempOfDay()) coldest = &day;
+        }
+    }
+    if (coldest == nullptr) throw runtime_error("No day found in the given range");
+    co_return *coldest;
+}
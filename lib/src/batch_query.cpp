@@ -0,0 +1,45 @@
+#include "batch_query.hpp"
+
+#include <algorithm>
+#include <latch>
+
+using namespace std;
+
+QueryResult runQuery(const ForecastQuery& query) {
+    QueryResult result;
+    try {
+        if (auto coldest = get_if<ColdestDayQuery>(&query)) {
+            result.value = coldest->forecast->findColdestDay(coldest->from, coldest->to);
+        } else if (auto sunny = get_if<NextSunnyDayQuery>(&query)) {
+            result.value = sunny->forecast->findNextSunnyDay(sunny->today);
+        } else if (auto month = get_if<MonthQuery>(&query)) {
+            result.value = month->forecast->giveAllDaysOfMonth(month->month);
+        }
+    } catch (...) {
+        result.value = monostate{};
+        result.error = current_exception();
+    }
+    return result;
+}
+
+vector<QueryResult> runBatch(ThreadPool& pool, const vector<ForecastQuery>& queries, size_t grain) {
+    if (grain == 0) throw invalid_argument("INVALID GRAIN\n");
+    vector<QueryResult> results(queries.size());
+    size_t tasks = (queries.size() + grain - 1) / grain;
+    latch done(static_cast<ptrdiff_t>(tasks));
+    for (size_t task = 0; task != tasks; task++) {
+        pool.submit([&queries, &results, &done, grain, task]() {
+            size_t begin = task * grain;
+            size_t end = min(begin + grain, queries.size());
+            for (size_t i = begin; i != end; i++) results[i] = runQuery(queries[i]);
+            done.count_down();
+        });
+    }
+    while (!done.try_wait()) {
+        if (!pool.tryRunOne()) {
+            done.wait();
+            break;
+        }
+    }
+    return results;
+}
@@ -0,0 +1,199 @@
+#include "concurrent_forecast.hpp"
+#include "forecast_queries.hpp"
+
+#include <algorithm>
+#include <array>
+
+using namespace std;
+
+ConcurrentForecast::ConcurrentForecast(size_t new_max_readers):
+    current(nullptr), global_epoch(0), max_readers(new_max_readers) {
+    if (new_max_readers == 0) throw invalid_argument("INVALID READERS COUNT\n");
+    slots = make_unique<ReaderSlot[]>(max_readers);
+    for (size_t i = 0; i != max_readers; i++) slots[i].epoch.store(IDLE, memory_order_relaxed);
+    current.store(new Version{make_shared<WeatherDay[]>(1), 1, 0, 0});
+}
+
+ConcurrentForecast::ConcurrentForecast(const Forecast& forecast, size_t new_max_readers):
+    ConcurrentForecast(new_max_readers) {
+    size_t count = forecast.getCount();
+    auto buffer = make_shared<WeatherDay[]>(max<size_t>(count, 1));
+    for (size_t i = 0; i != count; i++) buffer[i] = forecast[i];
+    lock_guard<mutex> guard(writer_lock);
+    publish(new Version{buffer, max<size_t>(count, 1), count, 1});
+}
+
+ConcurrentForecast::~ConcurrentForecast() {
+    for (auto& [epoch, version] : retired) delete version;
+    delete current.load();
+}
+
+void ConcurrentForecast::publish(Version* next) {
+    const Version* previous = current.exchange(next);
+    retired.emplace_back(global_epoch.load(), previous);
+    global_epoch.fetch_add(1);
+    reclaim();
+}
+
+void ConcurrentForecast::reclaim() {
+    uint64_t oldest_active = IDLE;
+    for (size_t i = 0; i != max_readers; i++) {
+        oldest_active = min(oldest_active, slots[i].epoch.load());
+    }
+    auto still_visible = remove_if(
+        retired.begin(),
+        retired.end(),
+        [oldest_active](const pair<uint64_t, const Version*>& entry) {
+            if (entry.first >= oldest_active) return false;
+            delete entry.second;
+            return true;
+        }
+    );
+    retired.erase(still_visible, retired.end());
+}
+
+ConcurrentForecast::Snapshot ConcurrentForecast::snapshot() const {
+    for (size_t i = 0; i != max_readers; i++) {
+        uint64_t expected = IDLE;
+        if (slots[i].epoch.compare_exchange_strong(expected, global_epoch.load())) {
+            return Snapshot(&slots[i], current.load());
+        }
+    }
+    throw runtime_error("TOO MANY SNAPSHOTS\n");
+}
+
+ConcurrentForecast& ConcurrentForecast::operator+=(const WeatherDay& new_day) {
+    append(span<const WeatherDay>(&new_day, 1));
+    return *this;
+}
+
+void ConcurrentForecast::append(span<const WeatherDay> new_days) {
+    if (new_days.empty()) return;
+    lock_guard<mutex> guard(writer_lock);
+    const Version* last = current.load();
+    size_t needed = last->count + new_days.size();
+    shared_ptr<WeatherDay[]> buffer = last->buffer;
+    size_t capacity = last->capacity;
+    if (needed > capacity) {
+        while (capacity < needed) capacity *= 2;
+        buffer = make_shared<WeatherDay[]>(capacity);
+        copy_n(last->buffer.get(), last->count, buffer.get());
+    }
+    copy(new_days.begin(), new_days.end(), buffer.get() + last->count);
+    publish(new Version{std::move(buffer), capacity, needed, last->number + 1});
+}
+
+void ConcurrentForecast::deleteByIndex(size_t index) {
+    lock_guard<mutex> guard(writer_lock);
+    const Version* last = current.load();
+    if (index >= last->count) throw invalid_argument("INVALID INDEX\n");
+    auto buffer = make_shared<WeatherDay[]>(last->capacity);
+    copy_n(last->buffer.get(), index, buffer.get());
+    copy(last->buffer.get() + index + 1, last->buffer.get() + last->count, buffer.get() + index);
+    publish(new Version{std::move(buffer), last->capacity, last->count - 1, last->number + 1});
+}
+
+void ConcurrentForecast::deleteAllErrors() {
+    lock_guard<mutex> guard(writer_lock);
+    const Version* last = current.load();
+    auto buffer = make_shared<WeatherDay[]>(last->capacity);
+    WeatherDay* end = copy_if(
+        last->buffer.get(),
+        last->buffer.get() + last->count,
+        buffer.get(),
+        [](const WeatherDay& day) { return day.check(); }
+    );
+    size_t kept = end - buffer.get();
+    publish(new Version{std::move(buffer), last->capacity, kept, last->number + 1});
+}
+
+void ConcurrentForecast::sortDaysByData() {
+    lock_guard<mutex> guard(writer_lock);
+    const Version* last = current.load();
+    auto buffer = make_shared<WeatherDay[]>(last->capacity);
+    copy_n(last->buffer.get(), last->count, buffer.get());
+    stable_sort(
+        buffer.get(),
+        buffer.get() + last->count,
+        [](const WeatherDay& a, const WeatherDay& b)
+        { return a.getDate() < b.getDate(); }
+    );
+    publish(new Version{std::move(buffer), last->capacity, last->count, last->number + 1});
+}
+
+uint64_t ConcurrentForecast::getVersion() const {
+    return current.load()->number;
+}
+
+size_t ConcurrentForecast::getRetiredCount() {
+    lock_guard<mutex> guard(writer_lock);
+    reclaim();
+    return retired.size();
+}
+
+ConcurrentForecast::Snapshot::Snapshot(ReaderSlot* new_slot, const Version* new_version):
+    slot(new_slot), version(new_version) {}
+
+ConcurrentForecast::Snapshot::Snapshot(Snapshot&& other) noexcept: slot(other.slot), version(other.version) {
+    other.slot = nullptr;
+    other.version = nullptr;
+}
+
+ConcurrentForecast::Snapshot& ConcurrentForecast::Snapshot::operator=(Snapshot&& other) noexcept {
+    if (this == &other) return *this;
+    if (slot != nullptr) slot->epoch.store(IDLE);
+    slot = other.slot;
+    version = other.version;
+    other.slot = nullptr;
+    other.version = nullptr;
+    return *this;
+}
+
+ConcurrentForecast::Snapshot::~Snapshot() {
+    if (slot != nullptr) slot->epoch.store(IDLE);
+}
+
+uint64_t ConcurrentForecast::Snapshot::getVersion() const {
+    return version->number;
+}
+
+size_t ConcurrentForecast::Snapshot::getCount() const {
+    return version->count;
+}
+
+span<const WeatherDay> ConcurrentForecast::Snapshot::days() const {
+    return span<const WeatherDay>(version->buffer.get(), version->count);
+}
+
+const WeatherDay& ConcurrentForecast::Snapshot::operator[](size_t index) const {
+    if (index >= version->count) throw out_of_range("INVALID INDEX");
+    return version->buffer[index];
+}
+
+WeatherDay ConcurrentForecast::Snapshot::findColdestDay(const Date& from, const Date& to) const {
+    if (version->count == 0) throw invalid_argument("DATA IS EMPTY\n");
+    const WeatherDay* result = findColdestDayIn(array{days()}, from, to);
+    if (result == nullptr) throw runtime_error("No day found in the given range");
+    return *result;
+}
+
+WeatherDay ConcurrentForecast::Snapshot::findNextSunnyDay(const Date& today) const {
+    if (version->count == 0) throw invalid_argument("DATA IS EMPTY");
+    const WeatherDay* result = findNextSunnyDayIn(array{days()}, today);
+    if (result == nullptr) throw runtime_error("No sunny day found after the given date");
+    return *result;
+}
+
+Forecast ConcurrentForecast::Snapshot::giveAllDaysOfMonth(size_t month) const {
+    if (version->count == 0) throw invalid_argument("DATA IS EMPTY\n");
+    if (month > 12 || month == 0) throw invalid_argument("INVALID MONTH\n");
+    Forecast result = collectDaysOfMonthIn(array{days()}, month);
+    if (result.getCount() == 0) throw runtime_error("There is no weather forecast for this month.\n");
+    return result;
+}
+
+Forecast ConcurrentForecast::Snapshot::toForecast() const {
+    Forecast result(max<size_t>(version->count, 1));
+    for (const WeatherDay& day : days()) result += day;
+    return result;
+}
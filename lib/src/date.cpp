@@ -13,19 +13,42 @@ Date::Date(uint32_t new_day, uint32_t new_month, int32_t new_year) {
     setYear(new_year);
 }
 
-void Date::setDay(uint32_t new_day) {
-    if(new_day > 31) throw invalid_argument("INVALID_ARGUMENT(day)");
+Expected<Date> Date::tryMake(uint32_t new_day, uint32_t new_month, int32_t new_year) {
+    Date result;
+    if (auto status = result.trySetDay(new_day); !status) return unexpected(status.error());
+    if (auto status = result.trySetMonth(new_month); !status) return unexpected(status.error());
+    if (auto status = result.trySetYear(new_year); !status) return unexpected(status.error());
+    return result;
+}
+
+Expected<void> Date::trySetDay(uint32_t new_day) {
+    if(new_day > 31) return unexpected(WeatherError::InvalidDay);
     day = new_day;
+    return {};
 }
 
-void Date::setMonth(uint32_t new_month) {
-    if(new_month > 12) throw invalid_argument("INVALID_ARGUMENT(month)");
+Expected<void> Date::trySetMonth(uint32_t new_month) {
+    if(new_month > 12) return unexpected(WeatherError::InvalidMonth);
     month = new_month;
+    return {};
 }
 
-void Date::setYear(int32_t new_year) {
-    if (new_year > 9999 || new_year < -999) throw invalid_argument("INVALID_ARGUMENT(year)");
+Expected<void> Date::trySetYear(int32_t new_year) {
+    if (new_year > 9999 || new_year < -999) return unexpected(WeatherError::InvalidYear);
     year = new_year;
+    return {};
+}
+
+void Date::setDay(uint32_t new_day) {
+    if(!trySetDay(new_day)) throw invalid_argument("INVALID_ARGUMENT(day)");
+}
+
+void Date::setMonth(uint32_t new_month) {
+    if(!trySetMonth(new_month)) throw invalid_argument("INVALID_ARGUMENT(month)");
+}
+
+void Date::setYear(int32_t new_year) {
+    if (!trySetYear(new_year)) throw invalid_argument("INVALID_ARGUMENT(year)");
 }
 
 uint32_t Date::getDay() const{
@@ -47,14 +70,12 @@ void Date::print() const{
 }
 
 bool operator>(const Date& first, const Date& second) {
-    if (first.year > second.year) return true;
-    if (first.month > second.month) return true;
-    return first.day > second.day;
+    return second < first;
 }
 
 bool operator<(const Date& first, const Date& second) {
-    if (first.year < second.year) return true;
-    if (first.month < second.month) return true;
+    if (first.year != second.year) return first.year < second.year;
+    if (first.month != second.month) return first.month < second.month;
     return first.day < second.day;
 }
 
@@ -69,14 +90,10 @@ istream& operator>>(std::istream& is, Date& obj) {
     int d, m, y;
     char dot1, dot2;
     if (is >> d >> dot1 >> m >> dot2 >> y) {
-        if (dot1 == '.' && dot2 == '.') {
-            try {
-                obj.setDay(d);
-                obj.setMonth(m);
-                obj.setYear(y);
-            } catch(...) {
-                is.setstate(std::ios::failbit);
-            }
+        if (dot1 == '.' && dot2 == '.' && d >= 0 && m >= 0) {
+            auto date = Date::tryMake(d, m, y);
+            if (date) obj = *date;
+            else is.setstate(std::ios::failbit);
         } else {
             is.setstate(std::ios::failbit);
         }
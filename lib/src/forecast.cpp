@@ -1,52 +1,184 @@
 #include "forecast.hpp"
+#include "forecast_metrics.hpp"
+#include "trace.hpp"
+#include "logging.hpp"
 
 #include <algorithm>
+#include <atomic>
+#include <bit>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <ranges>
+#include <span>
+#include <tuple>
+#include <variant>
 #include <vector>
 
 using namespace std;
 
+shared_ptr<WeatherDay[]> Forecast::allocateBuffer(size_t new_capacity) {
+    return allocate_shared<WeatherDay[]>(pmr::polymorphic_allocator<WeatherDay>(resource), new_capacity);
+}
+
 void Forecast::resize(size_t new_capacity) {
-    WeatherDay* newdata = new WeatherDay[new_capacity];
+    TraceSpan trace_span("Forecast::resize");
+    logMessage<LogLevel::Debug>(LogCategory::Forecast, "resize ", capacity, " -> ", new_capacity, ", copying ", count, " days");
+    addMetric(Metric::Resizes);
+    addMetric(Metric::ResizeBytesCopied, count * sizeof(WeatherDay));
+    shared_ptr<WeatherDay[]> new_storage = allocateBuffer(new_capacity);
     capacity = new_capacity;
-    copy_n(data, count, newdata);
-    delete [] data;
-    data = newdata;
+    copy_n(data, count, new_storage.get());
+    storage = std::move(new_storage);
+    data = storage.get();
+}
+
+void Forecast::detach() {
+    if (storage.use_count() <= 1) {
+        atomic_thread_fence(memory_order_acquire);
+        return;
+    }
+    // Не resize(): копия той же ёмкости — не перевыделение, и считается отдельно
+    addMetric(Metric::Detaches);
+    addMetric(Metric::DetachBytesCopied, count * sizeof(WeatherDay));
+    shared_ptr<WeatherDay[]> own_storage = allocateBuffer(capacity);
+    copy_n(data, count, own_storage.get());
+    storage = std::move(own_storage);
+    data = storage.get();
+}
+
+namespace {
+    enum QueryKind : unsigned { COLDEST_DAY, NEXT_SUNNY_DAY, DAYS_OF_MONTH };
+    constexpr size_t MAX_CACHED_QUERIES = 256; ///< При переполнении кэш очищается целиком
+}
+
+/**
+ * @brief Кэш результатов константных запросов, действительный для одного номера изменения.
+ */
+struct Forecast::QueryCache {
+    using Key = tuple<unsigned, int32_t, uint32_t, uint32_t, int32_t, uint32_t, uint32_t>;
+
+    mutex lock;                                      ///< Защищает entries и generation
+    uint64_t generation = 0;                         ///< Номер изменения, для которого верны entries
+    map<Key, variant<WeatherDay, Forecast>> entries; ///< Результаты по типу запроса и аргументам
+    atomic<uint64_t> hits{0};                        ///< Ответы из кэша
+    atomic<uint64_t> misses{0};                      ///< Вычисленные ответы
+    bool suspended = false;                          ///< Приостановлен неконстантным operator[]
+};
+
+template <typename Value, typename Compute>
+Expected<Value> Forecast::cachedQuery(unsigned kind, const Date& first, const Date& second, Compute compute) const {
+    if (!cache || cache->suspended) return compute();
+    QueryCache::Key key{kind, first.getYear(), first.getMonth(), first.getDay(),
+                        second.getYear(), second.getMonth(), second.getDay()};
+    {
+        lock_guard<mutex> guard(cache->lock);
+        if (cache->generation != generation) {
+            cache->entries.clear();
+            cache->generation = generation;
+        }
+        auto found = cache->entries.find(key);
+        if (found != cache->entries.end()) {
+            cache->hits.fetch_add(1, memory_order_relaxed);
+            addMetric(Metric::CacheHits);
+            return get<Value>(found->second);
+        }
+    }
+    cache->misses.fetch_add(1, memory_order_relaxed);
+    addMetric(Metric::CacheMisses);
+    Expected<Value> result = compute();
+    if (!result) return result;
+    lock_guard<mutex> guard(cache->lock);
+    if (cache->generation == generation) {
+        if (cache->entries.size() >= MAX_CACHED_QUERIES) {
+            logMessage<LogLevel::Debug>(LogCategory::Query, "query cache overflow, dropping ", cache->entries.size(), " entries");
+            cache->entries.clear();
+        }
+        cache->entries.emplace(key, *result);
+    }
+    return result;
 }
 
-Forecast::Forecast(): count(0), capacity(1) {
-    data = new WeatherDay[1];
+Forecast::Forecast(): resource(pmr::get_default_resource()), count(0), capacity(1), sorted(true),
+    lazy_delete(false), compaction_threshold(0.5), tombstones(0), generation(0) {
+    storage = allocateBuffer(1);
+    data = storage.get();
 }
 
-Forecast::Forecast(WeatherDay* new_data, size_t new_capacity): count(new_capacity), capacity(new_capacity) {
+Forecast::Forecast(WeatherDay* new_data, size_t new_capacity): resource(pmr::get_default_resource()),
+    count(new_capacity), capacity(new_capacity),
+    lazy_delete(false), compaction_threshold(0.5), tombstones(0), generation(0) {
     if(!new_data) throw invalid_argument("INVALID DATA\n");
+    storage = shared_ptr<WeatherDay[]>(new_data);
     data = new_data;
+    sorted = is_sorted(
+        data,
+        data + count,
+        [](const WeatherDay& a, const WeatherDay& b)
+        { return a.getDate() < b.getDate(); }
+    );
 }
 
-Forecast::Forecast(size_t initial_capacity): count(0), capacity(initial_capacity) {
-    if (initial_capacity == 0) throw "INVALID CAPACITY\n";
-    data = new WeatherDay[initial_capacity];
+Forecast::Forecast(size_t initial_capacity): Forecast(initial_capacity, pmr::get_default_resource()) {}
+
+Forecast::Forecast(size_t initial_capacity, pmr::memory_resource* memory_resource): resource(memory_resource),
+    count(0), capacity(initial_capacity), sorted(true),
+    lazy_delete(false), compaction_threshold(0.5), tombstones(0), generation(0) {
+    if (initial_capacity == 0) throw invalid_argument("INVALID CAPACITY\n");
+    if (memory_resource == nullptr) throw invalid_argument("INVALID MEMORY RESOURCE\n");
+    storage = allocateBuffer(initial_capacity);
+    data = storage.get();
+}
+
+Forecast::Forecast(const Forecast& other, pmr::memory_resource* memory_resource):
+    Forecast(max<size_t>(other.count - other.tombstones, 1), memory_resource) {
+    for (size_t i = 0; i != other.count; i++) {
+        if (other.isLiveAt(i)) data[count++] = other.data[i];
+    }
+    sorted = other.sorted;
+    lazy_delete = other.lazy_delete;
+    compaction_threshold = other.compaction_threshold;
+    if (other.cache) cache = make_unique<QueryCache>();
 }
 
-Forecast::~Forecast() {
-    delete[] data;
+Expected<Forecast> Forecast::tryMake(size_t initial_capacity) {
+    if (initial_capacity == 0) return unexpected(WeatherError::InvalidCapacity);
+    return Forecast(initial_capacity);
 }
 
-Forecast::Forecast(const Forecast& other): count(other.count), capacity(other.capacity) {
-    if (other.data == nullptr) throw "DATA IS EMPTY\n";
-    if (capacity == 0) throw "INVALID CAPACITY\n";
-    data = new WeatherDay[capacity];
-    copy(other.data, other.data + count, data);
+Forecast::~Forecast() = default;
+
+Forecast::Forecast(const Forecast& other): storage(other.storage), resource(other.resource), data(other.data),
+    count(other.count), capacity(other.capacity), sorted(other.sorted),
+    lazy_delete(other.lazy_delete), compaction_threshold(other.compaction_threshold), tombstones(other.tombstones),
+    removed(other.removed), live_tree(other.live_tree), generation(other.generation),
+    cache(other.cache ? make_unique<QueryCache>() : nullptr) {
+    if (other.data == nullptr) throw invalid_argument("DATA IS EMPTY\n");
+    // Буфер общий: запись через ссылку, полученную от other, видна и копии
+    if (cache) cache->suspended = other.cache->suspended;
+    if (capacity == 0) throw invalid_argument("INVALID CAPACITY\n");
 }
 
-Forecast::Forecast(Forecast&& other): data(other.data), count(other.count), capacity(other.capacity) {
+Forecast::Forecast(Forecast&& other): storage(std::move(other.storage)), resource(other.resource), data(other.data),
+    count(other.count), capacity(other.capacity), sorted(other.sorted),
+    lazy_delete(other.lazy_delete), compaction_threshold(other.compaction_threshold), tombstones(other.tombstones),
+    removed(std::move(other.removed)), live_tree(std::move(other.live_tree)),
+    generation(other.generation), cache(std::move(other.cache)) {
+    other.storage.reset();
     other.data = nullptr;
     other.count = 0;
     other.capacity = 0;
+    other.sorted = true;
+    other.tombstones = 0;
+    other.removed.clear();
+    other.live_tree.clear();
+    other.generation++;
 }
 
-void Forecast::deleteByIndex(size_t index) {
-    if (index >= count) throw invalid_argument("INVALID INDEX\n");
+void Forecast::eraseAt(size_t index) {
+    detach();
+    addMetric(Metric::DeleteShifts, count - 1 - index);
     for (size_t i = index; i != count - 1; i++) {
         data[i] = data[i + 1];
     }
@@ -54,8 +186,89 @@ void Forecast::deleteByIndex(size_t index) {
     if(count < capacity / 3) resize(capacity / 2);
 }
 
+size_t Forecast::physicalIndex(size_t index) const {
+    if (index >= count - tombstones) throw out_of_range("INVALID INDEX");
+    if (tombstones == 0) return index;
+    size_t pos = 0;
+    size_t remaining = index + 1;
+    for (size_t step = bit_floor(live_tree.size() - 1); step != 0; step >>= 1) {
+        if (pos + step < live_tree.size() && live_tree[pos + step] < remaining) {
+            pos += step;
+            remaining -= live_tree[pos];
+        }
+    }
+    return pos;
+}
+
+bool Forecast::isLiveAt(size_t index) const {
+    return tombstones == 0 || !removed[index];
+}
+
+void Forecast::buildIndex() {
+    removed.assign(count, false);
+    live_tree.assign(count + 1, 0);
+    for (size_t i = 1; i <= count; i++) {
+        live_tree[i] += 1;
+        size_t parent = i + (i & -i);
+        if (parent <= count) live_tree[parent] += live_tree[i];
+    }
+}
+
+void Forecast::deleteByIndex(size_t index) {
+    if (!tryDeleteByIndex(index)) throw invalid_argument("INVALID INDEX\n");
+}
+
+Expected<void> Forecast::tryDeleteByIndex(size_t index) {
+    if (index >= count - tombstones) return unexpected(WeatherError::InvalidIndex);
+    generation++;
+    if (!lazy_delete) {
+        eraseAt(index);
+        return {};
+    }
+    size_t physical = physicalIndex(index);
+    if (tombstones == 0) buildIndex();
+    removed[physical] = true;
+    for (size_t i = physical + 1; i < live_tree.size(); i += i & -i) live_tree[i]--;
+    ++tombstones;
+    if (tombstones > compaction_threshold * count) compact();
+    return {};
+}
+
+void Forecast::setLazyDeletion(bool enabled) {
+    if (enabled == lazy_delete) return;
+    compact();
+    lazy_delete = enabled;
+}
+
+bool Forecast::isLazyDeletion() const {
+    return lazy_delete;
+}
+
+void Forecast::setCompactionThreshold(double ratio) {
+    if (!(ratio > 0 && ratio <= 1)) throw invalid_argument("INVALID THRESHOLD\n");
+    compaction_threshold = ratio;
+}
+
+void Forecast::compact() {
+    if (tombstones == 0) return;
+    detach();
+    size_t kept = 0;
+    for (size_t i = 0; i != count; i++) {
+        if (!removed[i]) data[kept++] = data[i];
+    }
+    count = kept;
+    tombstones = 0;
+    removed.clear();
+    live_tree.clear();
+    if (count < capacity / 3) resize(max<size_t>(count * 2, 1));
+}
+
 void Forecast::deleteAllErrors() {
+    TraceSpan trace_span("Forecast::deleteAllErrors");
+    compact();
     if (count == 0) return;
+    generation++;
+    detach();
     size_t deleted_count = 0;
     auto new_end = remove_if(
         data, 
@@ -69,70 +282,314 @@ void Forecast::deleteAllErrors() {
     count = distance(data, new_end);
 }
 
-WeatherDay Forecast::findColdestDay(Date from, Date to) {
-    if(count == 0) throw invalid_argument("DATA IS EMPTY\n");
-    auto filter_view = std::ranges::filter_view(
-        std::span(data, count),
-        [from, to](const WeatherDay& day) 
-        { return day.getDate() > from && day.getDate() < to;}
-    );
-    auto coldest_day = min_element(
-        filter_view.begin(), 
-        filter_view.end(), 
-        [](const WeatherDay& a, const WeatherDay& b) 
-        { return a.averageTempOfDay() < b.averageTempOfDay();}
-    );
-    return *coldest_day;
+WeatherDay Forecast::findColdestDay(Date from, Date to) const {
+    Expected<WeatherDay> result = tryFindColdestDay(from, to);
+    if (result) return *result;
+    if (result.error() == WeatherError::NotFound) throw std::runtime_error("No day found in the given range");
+    throw invalid_argument("DATA IS EMPTY\n");
 }
 
-WeatherDay Forecast::findNextSunnyDay(const Date& today) {
-    if (count == 0) throw std::invalid_argument("DATA IS EMPTY");
-    auto filter_view = std::ranges::filter_view(
-        std::span(data, count),
-        [today](const WeatherDay& day) 
-        { return day.getPhenomen() == Phenomen::Sunny && day.getDate() > today;}
-    );
-    if(filter_view.empty()) throw std::runtime_error("No sunny day found after the given date");
-    auto result = min_element(
-        filter_view.begin(), 
-        filter_view.end(), 
-        [](const WeatherDay& a, const WeatherDay& b)
-        { return a.getDate() < b.getDate(); });
-    return *result;
+Expected<WeatherDay> Forecast::tryFindColdestDay(const Date& from, const Date& to) const {
+    TraceSpan trace_span("Forecast::findColdestDay", "query");
+    if(count == tombstones) return unexpected(WeatherError::EmptyData);
+    return cachedQuery<WeatherDay>(COLDEST_DAY, from, to, [this, &from, &to]() -> Expected<WeatherDay> {
+        addMetric(Metric::ScannedColdestDay, count);
+        auto filter_view = std::ranges::filter_view(
+            std::span(data, count),
+            [this, from, to](const WeatherDay& day) 
+            { return isLiveAt(&day - data) && day.getDate() > from && day.getDate() < to;}
+        );
+        auto coldest_day = min_element(
+            filter_view.begin(), 
+            filter_view.end(), 
+            [](const WeatherDay& a, const WeatherDay& b) 
+            { return a.averageTempOfDay() < b.averageTempOfDay();}
+        );
+        if(coldest_day == filter_view.end()) return unexpected(WeatherError::NotFound);
+        return *coldest_day;
+    });
 }
 
-Forecast Forecast::giveAllDaysOfMonth(size_t month) {
-    if (count == 0) throw invalid_argument("DATA IS EMPTY\n");
-    if (month > 12 || month == 0) throw invalid_argument("INVALID MONTH\n");
-    auto view = std::ranges::filter_view(
-        std::span(data, count),
-        [month](const WeatherDay& day) 
-        { return day.getDate().getMonth() == month;}
-    );
-    if(view.empty()) throw std::runtime_error("There is no weather forecast for this month.\n");
-    Forecast result;
-    for(auto& day : view) result += day;
+vector<optional<WeatherDay>> Forecast::findColdestDays(span<const DateRange> ranges) const {
+    TraceSpan trace_span("Forecast::findColdestDays", "query");
+    if (count == tombstones) throw invalid_argument("DATA IS EMPTY\n");
+    addMetric(Metric::ScannedColdestDays, count);
+    // Живые дни в порядке дат; при равных датах — в порядке хранения, как у findColdestDay
+    vector<size_t> order;
+    order.reserve(count - tombstones);
+    for (size_t i = 0; i < count; i++) if (isLiveAt(i)) order.push_back(i);
+    if (!sorted) {
+        stable_sort(order.begin(), order.end(),
+            [this](size_t a, size_t b) { return data[a].getDate() < data[b].getDate(); });
+    }
+    vector<int> temperature(order.size());
+    for (size_t pos = 0; pos < order.size(); pos++) temperature[pos] = data[order[pos]].averageTempOfDay();
+
+    // Диапазон дат -> полуинтервал позиций [begin, end)
+    struct Segment { size_t begin, end, query; };
+    vector<Segment> segments;
+    segments.reserve(ranges.size());
+    auto date_of = [this](size_t index) { return data[index].getDate(); };
+    for (size_t q = 0; q < ranges.size(); q++) {
+        auto begin = ranges::upper_bound(order, ranges[q].from, less<Date>(), date_of);
+        auto end = ranges::lower_bound(order, ranges[q].to, less<Date>(), date_of);
+        if (begin < end) segments.push_back({size_t(begin - order.begin()), size_t(end - order.begin()), q});
+    }
+    ranges::sort(segments, less<size_t>(), &Segment::end);
+
+    // Стек позиций с возрастающим ключом (температура, индекс хранения):
+    // минимум отрезка [begin, end) — первый элемент стека с позицией >= begin
+    auto colder = [&](size_t a, size_t b) {
+        return temperature[a] != temperature[b] ? temperature[a] < temperature[b] : order[a] < order[b];
+    };
+    vector<optional<WeatherDay>> result(ranges.size());
+    vector<size_t> stack;
+    size_t pushed = 0;
+    for (const Segment& segment : segments) {
+        for (; pushed < segment.end; pushed++) {
+            while (!stack.empty() && colder(pushed, stack.back())) stack.pop_back();
+            stack.push_back(pushed);
+        }
+        size_t pos = *ranges::lower_bound(stack, segment.begin);
+        result[segment.query] = data[order[pos]];
+    }
+    return result;
+}
+
+WeatherDay Forecast::findNextSunnyDay(const Date& today) const {
+    Expected<WeatherDay> result = tryFindNextSunnyDay(today);
+    if (result) return *result;
+    if (result.error() == WeatherError::NotFound) throw std::runtime_error("No sunny day found after the given date");
+    throw std::invalid_argument("DATA IS EMPTY");
+}
+
+Expected<WeatherDay> Forecast::tryFindNextSunnyDay(const Date& today) const {
+    TraceSpan trace_span("Forecast::findNextSunnyDay", "query");
+    if (count == tombstones) return unexpected(WeatherError::EmptyData);
+    return cachedQuery<WeatherDay>(NEXT_SUNNY_DAY, today, Date(), [this, &today]() -> Expected<WeatherDay> {
+        addMetric(Metric::ScannedNextSunnyDay, count);
+        auto filter_view = std::ranges::filter_view(
+            std::span(data, count),
+            [this, today](const WeatherDay& day) 
+            { return isLiveAt(&day - data) && day.getPhenomen() == Phenomen::Sunny && day.getDate() > today;}
+        );
+        if(filter_view.empty()) return unexpected(WeatherError::NotFound);
+        auto result = min_element(
+            filter_view.begin(), 
+            filter_view.end(), 
+            [](const WeatherDay& a, const WeatherDay& b)
+            { return a.getDate() < b.getDate(); });
+        return *result;
+    });
+}
+
+Forecast Forecast::giveAllDaysOfMonth(size_t month) const {
+    return giveAllDaysOfMonth(month, pmr::get_default_resource());
+}
+
+Forecast Forecast::giveAllDaysOfMonth(size_t month, pmr::memory_resource* resource) const {
+    Expected<Forecast> result = tryGiveAllDaysOfMonth(month, resource);
+    if (result) return *std::move(result);
+    switch (result.error()) {
+        case WeatherError::NotFound: throw std::runtime_error("There is no weather forecast for this month.\n");
+        case WeatherError::InvalidMonth: throw invalid_argument("INVALID MONTH\n");
+        default: throw invalid_argument("DATA IS EMPTY\n");
+    }
+}
+
+Expected<Forecast> Forecast::tryGiveAllDaysOfMonth(size_t month) const {
+    return tryGiveAllDaysOfMonth(month, pmr::get_default_resource());
+}
+
+Expected<Forecast> Forecast::tryGiveAllDaysOfMonth(size_t month, pmr::memory_resource* resource) const {
+    TraceSpan trace_span("Forecast::giveAllDaysOfMonth", "query");
+    if (count == tombstones) return unexpected(WeatherError::EmptyData);
+    if (month > 12 || month == 0) return unexpected(WeatherError::InvalidMonth);
+    if (resource == nullptr) resource = pmr::get_default_resource();
+    if (!cache) return collectMonth(month, resource);
+    // Кэш хранит результаты в источнике по умолчанию; для другого источника ответ копируется
+    Date key(0, static_cast<uint32_t>(month), 0);
+    Expected<Forecast> cached = cachedQuery<Forecast>(DAYS_OF_MONTH, key, Date(), [this, month]() {
+        return collectMonth(month, pmr::get_default_resource());
+    });
+    if (!cached || cached->getMemoryResource() == resource) return cached;
+    return Forecast(*cached, resource);
+}
+
+Expected<Forecast> Forecast::collectMonth(size_t month, pmr::memory_resource* resource) const {
+    addMetric(Metric::ScannedDaysOfMonth, count);
+    auto in_month = [this, month](size_t index) { return isLiveAt(index) && data[index].getDate().getMonth() == month; };
+    size_t matched = 0;
+    for (size_t i = 0; i != count; i++) {
+        if (in_month(i)) matched++;
+    }
+    if (matched == 0) return unexpected(WeatherError::NotFound);
+    Forecast result(matched, resource);
+    for (size_t i = 0; i != count; i++) {
+        if (in_month(i)) result.data[result.count++] = data[i];
+    }
+    result.sorted = sorted;
     result.sortDaysByData();
     return result;
 }
 
 void Forecast::sortDaysByData() {
-    sort(
-        data,
-        data+count,
-        [](const WeatherDay& a, const WeatherDay& b)
-        { return a.getDate() < b.getDate(); }
-    ); 
+    if (sorted) return;
+    TraceSpan trace_span("Forecast::sortDaysByData");
+    generation++;
+    addMetric(Metric::Sorts);
+    compact();
+    detach();
+    auto by_date = [](const WeatherDay& a, const WeatherDay& b)
+        { return a.getDate() < b.getDate(); };
+    // Естественная сортировка слиянием: уже упорядоченные участки сливаются
+    // попарно через один вспомогательный буфер из resource
+    pmr::vector<size_t> runs(1, 0, resource);
+    for (size_t i = 1; i < count; i++) {
+        if (by_date(data[i], data[i - 1])) runs.push_back(i);
+    }
+    runs.push_back(count);
+    if (runs.size() > 2) {
+        pmr::vector<WeatherDay> scratch(count, resource);
+        WeatherDay* from = data;
+        WeatherDay* to = scratch.data();
+        pmr::vector<size_t> merged(resource);
+        while (runs.size() > 2) {
+            merged.assign(1, 0);
+            for (size_t i = 2; i < runs.size(); i += 2) {
+                merge(from + runs[i - 2], from + runs[i - 1], from + runs[i - 1], from + runs[i], to + runs[i - 2], by_date);
+                merged.push_back(runs[i]);
+            }
+            if (runs.size() % 2 == 0) {
+                copy(from + runs[runs.size() - 2], from + runs.back(), to + runs[runs.size() - 2]);
+                merged.push_back(runs.back());
+            }
+            swap(from, to);
+            swap(runs, merged);
+        }
+        if (from != data) copy(from, from + count, data);
+    }
+    sorted = true;
+}
+
+bool Forecast::isSorted() const {
+    return sorted;
+}
+
+Forecast Forecast::mergeSorted(const Forecast& other, const DayResolver& resolver) const {
+    TraceSpan trace_span("Forecast::mergeSorted");
+    auto by_date = [](const WeatherDay& a, const WeatherDay& b)
+        { return a.getDate() < b.getDate(); };
+    auto ordered = [&by_date](const Forecast& f) {
+        if (f.sorted) return true;
+        auto live = std::ranges::filter_view(
+            std::span(f.data, f.count),
+            [&f](const WeatherDay& day) { return f.isLiveAt(&day - f.data); }
+        );
+        return ranges::is_sorted(live, by_date);
+    };
+    if (!ordered(*this) || !ordered(other)) throw invalid_argument("FORECAST IS NOT SORTED\n");
+
+    size_t total = getCount() + other.getCount();
+    Forecast result(total == 0 ? 1 : total);
+    auto emit = [&result, &resolver](const WeatherDay& day) {
+        if (result.count != 0 && result.data[result.count - 1].getDate() == day.getDate()) {
+            WeatherDay& last = result.data[result.count - 1];
+            if (resolver) resolver(last, day);
+            else last += day;
+        } else {
+            result.data[result.count++] = day;
+        }
+    };
+    auto skip_removed = [](const Forecast& f, size_t& k)
+        { while (k < f.count && !f.isLiveAt(k)) k++; };
+    size_t i = 0, j = 0;
+    skip_removed(*this, i);
+    skip_removed(other, j);
+    while (i < count && j < other.count) {
+        if (by_date(other.data[j], data[i])) {
+            emit(other.data[j++]);
+            skip_removed(other, j);
+        } else {
+            emit(data[i++]);
+            skip_removed(*this, i);
+        }
+    }
+    for (; i < count; i++) if (isLiveAt(i)) emit(data[i]);
+    for (; j < other.count; j++) if (other.isLiveAt(j)) emit(other.data[j]);
+    return result;
+}
+
+Forecast Forecast::operator|(const Forecast& other) const {
+    return mergeSorted(other);
+}
+
+size_t Forecast::getCount() const {
+    return count - tombstones;
+}
+
+void Forecast::setQueryCache(bool enabled) {
+    if (enabled && cache) cache->suspended = false;
+    if (enabled == static_cast<bool>(cache)) return;
+    cache = enabled ? make_unique<QueryCache>() : nullptr;
+}
+
+bool Forecast::isQueryCacheEnabled() const {
+    return static_cast<bool>(cache);
+}
+
+uint64_t Forecast::getCacheHits() const {
+    return cache ? cache->hits.load(memory_order_relaxed) : 0;
+}
+
+uint64_t Forecast::getCacheMisses() const {
+    return cache ? cache->misses.load(memory_order_relaxed) : 0;
+}
+
+uint64_t Forecast::getGeneration() const {
+    return generation;
+}
+
+pmr::memory_resource* Forecast::getMemoryResource() const {
+    return resource;
+}
+
+MemoryUsage Forecast::memoryUsage() const {
+    MemoryUsage usage;
+    usage.live_bytes = (count - tombstones) * sizeof(WeatherDay);
+    usage.tombstone_bytes = tombstones * sizeof(WeatherDay);
+    usage.slack_bytes = (capacity - count) * sizeof(WeatherDay);
+    usage.index_bytes = (removed.capacity() + 7) / 8 + live_tree.capacity() * sizeof(size_t);
+    usage.buffer_owners = static_cast<size_t>(storage.use_count());
+    if (cache) {
+        lock_guard<mutex> guard(cache->lock);
+        usage.cache_bytes = sizeof(QueryCache);
+        // Узел std::map: ключ, значение и три указателя с цветом
+        for (const auto& [key, value] : cache->entries) {
+            usage.cache_bytes += sizeof(key) + sizeof(value) + 4 * sizeof(void*);
+            if (const Forecast* month = get_if<Forecast>(&value)) usage.cache_bytes += month->memoryUsage().totalBytes();
+        }
+    }
+    return usage;
+}
+
+size_t Forecast::getCapacity() const {
+    return capacity;
 }
 
 void Forecast::mergeDaysByData() {
+    TraceSpan trace_span("Forecast::mergeDaysByData");
+    compact();
+    if (count == 0) return;
+    generation++;
+    detach();
     for(size_t i = count - 1; i != 0; i--) {
         WeatherDay& day = data[i];
         size_t j = i - 1;
         while(true) {
             if(day.getDate() == data[j].getDate()) {
                 day += data[j];
-                deleteByIndex(j);
+                eraseAt(j);
             }
             if(j == 0) break;
             j--;
@@ -141,51 +598,124 @@ void Forecast::mergeDaysByData() {
 }
 
 Forecast& Forecast::operator+=(const WeatherDay& new_day) {
+    generation++;
     if(count == capacity) resize(capacity * 2);
-    cout << "BHKNTGN\n";
+    else detach();
+    logMessage<LogLevel::Trace>(LogCategory::Forecast, "append day ", count);
+    if(count != 0 && new_day.getDate() < data[count - 1].getDate()) sorted = false;
     data[count++] = new_day;
+    if (tombstones != 0) extendIndex();
     return *this;
 }
 
+void Forecast::append(span<const WeatherDay> new_days) {
+    if (new_days.empty()) return;
+    generation++;
+    size_t needed = count + new_days.size();
+    if (needed > capacity) {
+        size_t new_capacity = max<size_t>(capacity, 1);
+        while (new_capacity < needed) new_capacity *= 2;
+        resize(new_capacity);
+    } else {
+        detach();
+    }
+    auto by_date = [](const WeatherDay& a, const WeatherDay& b)
+        { return a.getDate() < b.getDate(); };
+    if (sorted) {
+        sorted = is_sorted(new_days.begin(), new_days.end(), by_date)
+            && (count == 0 || !by_date(new_days.front(), data[count - 1]));
+    }
+    copy(new_days.begin(), new_days.end(), data + count);
+    for (size_t i = 0; i != new_days.size(); i++) {
+        count++;
+        if (tombstones != 0) extendIndex();
+    }
+}
+
+void Forecast::extendIndex() {
+    removed.push_back(false);
+    size_t node = count;
+    size_t live = 1;
+    for (size_t i = node - 1; i > node - (node & -node); i -= i & -i) live += live_tree[i];
+    live_tree.push_back(live);
+}
+
 WeatherDay& Forecast::operator[](size_t index) {
-    if (index >= count) throw out_of_range("INVALID INDEX");
-        return data[index];
+    size_t physical = physicalIndex(index);
+    generation++;
+    detach();
+    sorted = false;
+    // Запись через сохранённую ссылку возможна после любого запроса
+    if (cache) cache->suspended = true;
+    return data[physical];
+}
+
+const WeatherDay& Forecast::operator[](size_t index) const {
+    return data[physicalIndex(index)];
 }
 
 Forecast& Forecast::operator=(const Forecast& other) {
     if (this == &other) return *this;
     if (other.data != nullptr) {
-        WeatherDay* new_data = new WeatherDay[other.capacity];
-        copy(other.data, other.data + other.count, new_data);
-        delete [] data;
-        data = new_data;
+        storage = other.storage;
+        data = other.data;
         count = other.count;
         capacity = other.capacity;
+        sorted = other.sorted;
+        tombstones = other.tombstones;
+        removed = other.removed;
+        live_tree = other.live_tree;
     } else {
+        storage.reset();
         data = nullptr;
         capacity = 0;
         count = 0;
+        sorted = true;
+        tombstones = 0;
+        removed.clear();
+        live_tree.clear();
     }
+    lazy_delete = other.lazy_delete;
+    compaction_threshold = other.compaction_threshold;
+    generation = other.generation;
+    cache = other.cache ? make_unique<QueryCache>() : nullptr;
+    if (cache) cache->suspended = other.cache->suspended;
     return *this;
 }
 
 Forecast& Forecast::operator=(Forecast&& other) noexcept {
     if (this == &other) return *this;
-    delete[] data;
+    storage = std::move(other.storage);
     data = other.data;
     count = other.count;
     capacity = other.capacity;
+    sorted = other.sorted;
+    lazy_delete = other.lazy_delete;
+    compaction_threshold = other.compaction_threshold;
+    tombstones = other.tombstones;
+    removed = std::move(other.removed);
+    live_tree = std::move(other.live_tree);
+    generation = other.generation;
+    cache = std::move(other.cache);
+    other.generation++;
+    other.storage.reset();
     other.data = nullptr;
     other.capacity = 0;
     other.count = 0;
+    other.sorted = true;
+    other.tombstones = 0;
+    other.removed.clear();
+    other.live_tree.clear();
     return *this;
 }
 
 
 ostream& operator<<(std::ostream& os, const Forecast& obj) {
     os << "===========================" << endl;
+    size_t number = 0;
     for(size_t index = 0; index != obj.count; index++) {
-        os << index + 1 << "." << obj.data[index];
+        if (!obj.isLiveAt(index)) continue;
+        os << ++number << "." << obj.data[index];
         os << "===========================" << endl;
     }
     return os;
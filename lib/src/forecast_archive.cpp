@@ -0,0 +1,484 @@
+#include "forecast_archive.hpp"
+#include "trace.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+
+using namespace std;
+
+namespace {
+    constexpr char ARCHIVE_MAGIC[8] = {'W', 'F', 'A', 'R', 'C', '0', '0', '1'};
+
+    // Метки способа хранения осадков: младший бит 0 — десятые доли,
+    // младшие биты 01 — сотые доли, 11 — далее 8 байт double
+    constexpr uint64_t PRECIPITATION_HUNDREDTHS = 1;
+    constexpr uint64_t PRECIPITATION_RAW = 3;
+    constexpr double MAX_SCALED_PRECIPITATION = 1e15;
+    constexpr int MAX_PHENOMEN = 7;
+    // Разности дат 0, 1, 2 хранятся в одном varint с длиной серии, 3 — далее разность
+    constexpr uint64_t DATE_DELTA_ESCAPE = 3;
+    // Границы значений, которые примут Date и Weather: повреждённые данные
+    // отсекаются при декодировании, а не исключениями конструкторов
+    constexpr int64_t MIN_DATE_KEY = -999 * 512;
+    constexpr int64_t MAX_DATE_KEY = 9999 * 512 + 12 * 32 + 31;
+    constexpr int64_t MIN_TEMPERATURE = -273;
+    constexpr int64_t MAX_TEMPERATURE = numeric_limits<int32_t>::max();
+
+    /**
+     * @brief Запись индекса в файле архива.
+     */
+    struct IndexRecord {
+        int32_t first;      ///< Ключ первой даты блока
+        int32_t last;       ///< Ключ последней даты блока
+        uint32_t count;     ///< Количество дней
+        uint32_t size;      ///< Размер блока в байтах
+        uint64_t offset;    ///< Смещение блока в данных
+    };
+
+    static_assert(sizeof(IndexRecord) == 24);
+
+    int32_t dateKey(const Date& date) {
+        return date.getYear() * 512 + static_cast<int32_t>(date.getMonth() * 32 + date.getDay());
+    }
+
+    bool isValidKey(int64_t key) {
+        return key >= MIN_DATE_KEY && key <= MAX_DATE_KEY && ((key & 511) >> 5) <= 12;
+    }
+
+    Date keyDate(int32_t key) {
+        int32_t year = key >= 0 ? key / 512 : -((511 - key) / 512);
+        int32_t rest = key - year * 512;
+        return Date(rest & 31, rest >> 5, year);
+    }
+
+    uint64_t zigzag(int64_t value) {
+        return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+    }
+
+    int64_t unzigzag(uint64_t value) {
+        return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+    }
+
+    void putVarint(vector<uint8_t>& out, uint64_t value) {
+        while (value >= 0x80) {
+            out.push_back(static_cast<uint8_t>(value) | 0x80);
+            value >>= 7;
+        }
+        out.push_back(static_cast<uint8_t>(value));
+    }
+
+    /**
+     * @brief Последовательное чтение значений блока с проверкой границ.
+     */
+    struct BlockReader {
+        const uint8_t* pos;
+        const uint8_t* end;
+
+        [[noreturn]] static void corrupted() {
+            throw runtime_error("CORRUPTED ARCHIVE BLOCK\n");
+        }
+
+        uint64_t varint() {
+            if (pos != end && *pos < 0x80) return *pos++;
+            uint64_t result = 0;
+            for (unsigned shift = 0; shift < 64; shift += 7) {
+                if (pos == end) corrupted();
+                uint8_t byte = *pos++;
+                result |= static_cast<uint64_t>(byte & 0x7f) << shift;
+                if ((byte & 0x80) == 0) return result;
+            }
+            corrupted();
+        }
+
+        int64_t signedVarint() {
+            return unzigzag(varint());
+        }
+
+        double raw() {
+            if (end - pos < static_cast<ptrdiff_t>(sizeof(double))) corrupted();
+            double value;
+            memcpy(&value, pos, sizeof(value));
+            pos += sizeof(value);
+            return value;
+        }
+    };
+
+    void putDateRun(vector<uint8_t>& out, uint64_t delta, uint64_t run) {
+        putVarint(out, run << 2 | min(delta, DATE_DELTA_ESCAPE));
+        if (delta >= DATE_DELTA_ESCAPE) putVarint(out, delta);
+    }
+
+    bool isDry(double precipitation) {
+        return precipitation == 0 && !signbit(precipitation);
+    }
+
+    void putPrecipitation(vector<uint8_t>& out, double precipitation) {
+        if (precipitation < MAX_SCALED_PRECIPITATION) {
+            uint64_t tenths = static_cast<uint64_t>(llround(precipitation * 10));
+            if (tenths / 10.0 == precipitation) return putVarint(out, tenths << 1);
+            uint64_t hundredths = static_cast<uint64_t>(llround(precipitation * 100));
+            if (hundredths / 100.0 == precipitation) return putVarint(out, hundredths << 2 | PRECIPITATION_HUNDREDTHS);
+        }
+        putVarint(out, PRECIPITATION_RAW);
+        uint8_t bytes[sizeof(double)];
+        memcpy(bytes, &precipitation, sizeof(double));
+        out.insert(out.end(), bytes, bytes + sizeof(double));
+    }
+
+    double readPrecipitation(BlockReader& reader) {
+        uint64_t value = reader.varint();
+        if ((value & 1) == 0) return (value >> 1) / 10.0;
+        if ((value & 3) == PRECIPITATION_HUNDREDTHS) return (value >> 2) / 100.0;
+        double precipitation = reader.raw();
+        if (precipitation < 0) BlockReader::corrupted();
+        return precipitation;
+    }
+
+    int32_t addTemperature(int64_t& temperature, int64_t delta) {
+        // Разность ограничена заранее, чтобы сумма не переполнилась
+        if (delta < MIN_TEMPERATURE - MAX_TEMPERATURE || delta > MAX_TEMPERATURE - MIN_TEMPERATURE) BlockReader::corrupted();
+        temperature += delta;
+        if (temperature < MIN_TEMPERATURE || temperature > MAX_TEMPERATURE) BlockReader::corrupted();
+        return static_cast<int32_t>(temperature);
+    }
+
+    int temperatureAt(const WeatherDay& day, int part) {
+        PartsOfDay parts = day.getPartsOfDay();
+        if (part == 0) return parts.getMorning().getTemperature();
+        if (part == 1) return parts.getDay().getTemperature();
+        return parts.getEvening().getTemperature();
+    }
+}
+
+void encodeArchiveBlock(span<const WeatherDay> days, vector<uint8_t>& out) {
+    putVarint(out, days.size());
+    if (days.empty()) return;
+
+    // Даты: первый ключ и серии одинаковых разностей
+    int32_t previous = dateKey(days[0].getDate());
+    putVarint(out, zigzag(previous));
+    uint64_t delta = 0, run = 0;
+    for (size_t i = 1; i != days.size(); i++) {
+        int32_t key = dateKey(days[i].getDate());
+        if (key < previous) throw invalid_argument("FORECAST IS NOT SORTED\n");
+        uint64_t current = static_cast<uint64_t>(key - previous);
+        if (run != 0 && current != delta) {
+            putDateRun(out, delta, run);
+            run = 0;
+        }
+        delta = current;
+        run++;
+        previous = key;
+    }
+    if (run != 0) putDateRun(out, delta, run);
+
+    // Температуры: разности с предыдущим днём; младший бит вечерней разности —
+    // признак дня без осадков, для таких дней осадки не записываются
+    int64_t last[3] = {0, 0, 0};
+    for (const WeatherDay& day : days) {
+        for (int part = 0; part != 3; part++) {
+            int64_t temperature = temperatureAt(day, part);
+            uint64_t value = zigzag(temperature - last[part]);
+            if (part == 2) value = value << 1 | (isDry(day.getPrecipitation()) ? 1 : 0);
+            putVarint(out, value);
+            last[part] = temperature;
+        }
+    }
+
+    for (const WeatherDay& day : days) {
+        if (!isDry(day.getPrecipitation())) putPrecipitation(out, day.getPrecipitation());
+    }
+
+    // Явления: длина серии дней, где явление совпадает с вычисленным
+    // конструктором WeatherDay, и явление-исключение (0 — конец блока)
+    uint64_t skipped = 0;
+    for (const WeatherDay& day : days) {
+        Phenomen phenomen = day.getPhenomen();
+        if (WeatherDay(day.getDate(), day.getPrecipitation(), day.getPartsOfDay()).getPhenomen() == phenomen) {
+            skipped++;
+            continue;
+        }
+        int value = static_cast<int>(phenomen);
+        if (value < static_cast<int>(Phenomen::Sunny) || value > MAX_PHENOMEN) {
+            throw invalid_argument(errorMessage(WeatherError::NotRepresentable));
+        }
+        putVarint(out, skipped << 3 | static_cast<uint64_t>(value));
+        skipped = 0;
+    }
+    putVarint(out, skipped << 3);
+}
+
+namespace {
+    /**
+     * @brief Декодированный блок по столбцам; буферы переиспользуются между блоками.
+     */
+    struct BlockColumns {
+        size_t count = 0;
+        vector<int32_t> keys;           ///< Ключи дат
+        vector<int32_t> morning;        ///< Температуры утром
+        vector<int32_t> noon;           ///< Температуры днём
+        vector<int32_t> evening;        ///< Температуры вечером
+        vector<double> precipitation;   ///< Осадки
+        vector<uint8_t> phenomen;       ///< Явление-исключение, 0 — вычисляется конструктором WeatherDay
+
+        void resize(size_t new_count) {
+            count = new_count;
+            if (keys.size() >= count) return;
+            keys.resize(count);
+            morning.resize(count);
+            noon.resize(count);
+            evening.resize(count);
+            precipitation.resize(count);
+            phenomen.resize(count);
+        }
+
+        WeatherDay day(size_t index) const {
+            Weather weather;
+            PartsOfDay parts;
+            weather.setTemperature(morning[index]);
+            parts.setMorning(weather);
+            weather.setTemperature(noon[index]);
+            parts.setDay(weather);
+            weather.setTemperature(evening[index]);
+            parts.setEvening(weather);
+            WeatherDay result(keyDate(keys[index]), precipitation[index], parts);
+            if (phenomen[index] != 0) result.setPhenomen(phenomen[index]);
+            return result;
+        }
+
+        void appendTo(vector<WeatherDay>& out) const {
+            out.reserve(out.size() + count);
+            Weather morning_weather, noon_weather, evening_weather;
+            PartsOfDay parts;
+            for (size_t i = 0; i != count; i++) {
+                morning_weather.setTemperature(morning[i]);
+                noon_weather.setTemperature(noon[i]);
+                evening_weather.setTemperature(evening[i]);
+                parts.setMorning(morning_weather);
+                parts.setDay(noon_weather);
+                parts.setEvening(evening_weather);
+                out.emplace_back(keyDate(keys[i]), precipitation[i], parts);
+                if (phenomen[i] != 0) out.back().setPhenomen(phenomen[i]);
+            }
+        }
+    };
+
+    void decodeColumns(span<const uint8_t> block, BlockColumns& columns) {
+        BlockReader reader{block.data(), block.data() + block.size()};
+        uint64_t count = reader.varint();
+        if (count > block.size()) BlockReader::corrupted();
+        columns.resize(count);
+        if (count == 0) return;
+
+        int64_t key = reader.signedVarint();
+        if (!isValidKey(key)) BlockReader::corrupted();
+        columns.keys[0] = static_cast<int32_t>(key);
+        for (size_t i = 1; i != count;) {
+            uint64_t value = reader.varint();
+            uint64_t run = value >> 2;
+            uint64_t delta = value & 3;
+            if (delta == DATE_DELTA_ESCAPE) delta = reader.varint();
+            if (run == 0 || run > count - i || delta > MAX_DATE_KEY - MIN_DATE_KEY) BlockReader::corrupted();
+            for (size_t end = i + run; i != end; i++) {
+                key += static_cast<int64_t>(delta);
+                if (!isValidKey(key)) BlockReader::corrupted();
+                columns.keys[i] = static_cast<int32_t>(key);
+            }
+        }
+
+        // Обычно все три разности однобайтовые: проверяем их разом.
+        // Сухие дни помечаются нулём в precipitation, остальные — единицей до чтения осадков
+        int64_t morning = 0, noon = 0, evening = 0;
+        for (size_t i = 0; i != count; i++) {
+            const uint8_t* bytes = reader.pos;
+            uint64_t evening_value;
+            if (reader.end - bytes >= 3 && ((bytes[0] | bytes[1] | bytes[2]) & 0x80) == 0) {
+                columns.morning[i] = addTemperature(morning, unzigzag(bytes[0]));
+                columns.noon[i] = addTemperature(noon, unzigzag(bytes[1]));
+                evening_value = bytes[2];
+                reader.pos += 3;
+            } else {
+                columns.morning[i] = addTemperature(morning, reader.signedVarint());
+                columns.noon[i] = addTemperature(noon, reader.signedVarint());
+                evening_value = reader.varint();
+            }
+            columns.evening[i] = addTemperature(evening, unzigzag(evening_value >> 1));
+            columns.precipitation[i] = (evening_value & 1) ? 0.0 : 1.0;
+        }
+
+        for (size_t i = 0; i != count; i++) {
+            if (columns.precipitation[i] != 0) columns.precipitation[i] = readPrecipitation(reader);
+        }
+
+        for (size_t i = 0;;) {
+            uint64_t value = reader.varint();
+            uint64_t skipped = value >> 3;
+            if (skipped > count - i) BlockReader::corrupted();
+            fill_n(columns.phenomen.begin() + i, skipped, 0);
+            i += skipped;
+            if ((value & 7) == 0) {
+                if (i != count) BlockReader::corrupted();
+                break;
+            }
+            if (i == count) BlockReader::corrupted();
+            columns.phenomen[i++] = static_cast<uint8_t>(value & 7);
+        }
+        if (reader.pos != reader.end) BlockReader::corrupted();
+    }
+}
+
+size_t decodeArchiveBlock(span<const uint8_t> block, vector<WeatherDay>& out) {
+    BlockColumns columns;
+    decodeColumns(block, columns);
+    columns.appendTo(out);
+    return columns.count;
+}
+
+ForecastArchive::ForecastArchive(): count(0) {}
+
+ForecastArchive::ForecastArchive(const Forecast& forecast, size_t block_days): count(0) {
+    if (block_days == 0) throw invalid_argument("INVALID BLOCK SIZE\n");
+    TraceSpan trace_span("ForecastArchive::encode", "io");
+    vector<WeatherDay> block;
+    block.reserve(min(block_days, forecast.getCount()));
+    auto flush = [this, &block]() {
+        if (!index.empty() && block.front().getDate() < index.back().last) {
+            throw invalid_argument("FORECAST IS NOT SORTED\n");
+        }
+        size_t offset = data.size();
+        encodeArchiveBlock(block, data);
+        index.push_back({block.front().getDate(), block.back().getDate(), static_cast<uint32_t>(block.size()),
+                         offset, static_cast<uint32_t>(data.size() - offset)});
+        count += block.size();
+        block.clear();
+    };
+    for (size_t i = 0; i != forecast.getCount(); i++) {
+        block.push_back(forecast[i]);
+        if (block.size() == block_days) flush();
+    }
+    if (!block.empty()) flush();
+    data.shrink_to_fit();
+}
+
+size_t ForecastArchive::getCount() const {
+    return count;
+}
+
+const vector<ArchiveBlockInfo>& ForecastArchive::blocks() const {
+    return index;
+}
+
+span<const uint8_t> ForecastArchive::blockData(size_t block) const {
+    if (block >= index.size()) throw out_of_range("INVALID INDEX");
+    return span<const uint8_t>(data).subspan(index[block].offset, index[block].size);
+}
+
+size_t ForecastArchive::compressedBytes() const {
+    return data.size();
+}
+
+void ForecastArchive::decodeBlock(size_t block, vector<WeatherDay>& out) const {
+    decodeArchiveBlock(blockData(block), out);
+}
+
+vector<WeatherDay> ForecastArchive::decodeRange(const Date& from, const Date& to) const {
+    TraceSpan trace_span("ForecastArchive::decodeRange", "io");
+    vector<WeatherDay> result;
+    vector<WeatherDay> days;
+    auto first = partition_point(index.begin(), index.end(),
+        [&from](const ArchiveBlockInfo& info) { return info.last < from; });
+    for (auto it = first; it != index.end() && !(to < it->first); ++it) {
+        days.clear();
+        decodeBlock(it - index.begin(), days);
+        for (const WeatherDay& day : days) {
+            if (!(day.getDate() < from) && !(to < day.getDate())) result.push_back(day);
+        }
+    }
+    return result;
+}
+
+WeatherDay ForecastArchive::findColdestDay(const Date& from, const Date& to) const {
+    if (count == 0) throw invalid_argument("DATA IS EMPTY\n");
+    TraceSpan trace_span("ForecastArchive::findColdestDay", "query");
+    int32_t from_key = dateKey(from);
+    int32_t to_key = dateKey(to);
+    BlockColumns columns;
+    optional<WeatherDay> coldest;
+    int coldest_average = 0;
+    auto first = partition_point(index.begin(), index.end(),
+        [&from](const ArchiveBlockInfo& info) { return !(from < info.last); });
+    for (auto it = first; it != index.end() && it->first < to; ++it) {
+        decodeColumns(blockData(it - index.begin()), columns);
+        size_t found = columns.count;
+        for (size_t i = 0; i != columns.count; i++) {
+            if (columns.keys[i] <= from_key || columns.keys[i] >= to_key) continue;
+            int average = (columns.morning[i] + columns.noon[i] + columns.evening[i]) / 3;
+            if ((!coldest && found == columns.count) || average < coldest_average) {
+                coldest_average = average;
+                found = i;
+            }
+        }
+        if (found != columns.count) coldest = columns.day(found);
+    }
+    if (!coldest) throw runtime_error("No day found in the given range");
+    return *coldest;
+}
+
+Forecast ForecastArchive::toForecast() const {
+    TraceSpan trace_span("ForecastArchive::toForecast", "io");
+    vector<WeatherDay> days;
+    days.reserve(count);
+    for (size_t i = 0; i != index.size(); i++) decodeBlock(i, days);
+    Forecast result(count == 0 ? 1 : count);
+    result.append(days);
+    return result;
+}
+
+void ForecastArchive::write(ostream& out) const {
+    uint64_t header[2] = {count, index.size()};
+    out.write(ARCHIVE_MAGIC, sizeof(ARCHIVE_MAGIC));
+    out.write(reinterpret_cast<const char*>(header), sizeof(header));
+    for (const ArchiveBlockInfo& info : index) {
+        IndexRecord record{dateKey(info.first), dateKey(info.last), info.count, info.size, info.offset};
+        out.write(reinterpret_cast<const char*>(&record), sizeof(record));
+    }
+    uint64_t size = data.size();
+    out.write(reinterpret_cast<const char*>(&size), sizeof(size));
+    out.write(reinterpret_cast<const char*>(data.data()), static_cast<streamsize>(data.size()));
+}
+
+ForecastArchive ForecastArchive::read(istream& in) {
+    char magic[sizeof(ARCHIVE_MAGIC)];
+    uint64_t header[2];
+    if (!in.read(magic, sizeof(magic)) || memcmp(magic, ARCHIVE_MAGIC, sizeof(magic)) != 0
+        || !in.read(reinterpret_cast<char*>(header), sizeof(header))) {
+        throw runtime_error("INVALID ARCHIVE HEADER\n");
+    }
+    ForecastArchive result;
+    uint64_t total = 0;
+    for (uint64_t i = 0; i != header[1]; i++) {
+        IndexRecord record;
+        if (!in.read(reinterpret_cast<char*>(&record), sizeof(record)) || !isValidKey(record.first) || !isValidKey(record.last)) {
+            throw runtime_error("INVALID ARCHIVE INDEX\n");
+        }
+        result.index.push_back({keyDate(record.first), keyDate(record.last), record.count, record.offset, record.size});
+        total += record.count;
+    }
+    uint64_t size;
+    if (!in.read(reinterpret_cast<char*>(&size), sizeof(size)) || total != header[0]) {
+        throw runtime_error("INVALID ARCHIVE INDEX\n");
+    }
+    for (const ArchiveBlockInfo& info : result.index) {
+        if (info.offset > size || info.size > size - info.offset) throw runtime_error("INVALID ARCHIVE INDEX\n");
+    }
+    result.data.resize(size);
+    if (!in.read(reinterpret_cast<char*>(result.data.data()), static_cast<streamsize>(size))) {
+        throw runtime_error("INVALID ARCHIVE INDEX\n");
+    }
+    result.count = total;
+    return result;
+}
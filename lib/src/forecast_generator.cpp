@@ -0,0 +1,107 @@
+#include "forecast_generator.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <numbers>
+#include <random>
+#include <stdexcept>
+
+using namespace std;
+
+namespace {
+    uint64_t splitmix64(uint64_t value) {
+        value += 0x9e3779b97f4a7c15ull;
+        value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ull;
+        value = (value ^ (value >> 27)) * 0x94d049bb133111ebull;
+        return value ^ (value >> 31);
+    }
+
+    /**
+     * @brief Поток случайных чисел одного дня.
+     */
+    class DayRandom {
+    private:
+        uint64_t state;
+
+    public:
+        DayRandom(uint64_t seed, uint64_t index): state(splitmix64(seed ^ splitmix64(index))) {}
+
+        uint64_t next() {
+            state = splitmix64(state);
+            return state;
+        }
+
+        double uniform() {
+            return static_cast<double>(next() >> 11) * 0x1.0p-53;
+        }
+
+        int between(int low, int high) {
+            return low + static_cast<int>(next() % static_cast<uint64_t>(high - low + 1));
+        }
+    };
+}
+
+ForecastGenerator::ForecastGenerator(const GeneratorOptions& new_options): options(new_options) {
+    if (options.duplicate_ratio < 0 || options.duplicate_ratio >= 1) throw invalid_argument("INVALID_ARGUMENT(duplicate_ratio)");
+    if (options.error_ratio < 0 || options.error_ratio > 1) throw invalid_argument("INVALID_ARGUMENT(error_ratio)");
+    if (options.stations == 0) throw invalid_argument("INVALID_ARGUMENT(stations)");
+    chrono::year_month_day first{chrono::year(options.start.getYear()), chrono::month(options.start.getMonth()),
+                                 chrono::day(options.start.getDay())};
+    start_day = chrono::sys_days(first).time_since_epoch().count();
+    chrono::year_month_day last{chrono::year(9999), chrono::December, chrono::day(31)};
+    period_days = chrono::sys_days(last).time_since_epoch().count() - start_day + 1;
+    if (options.span_days != 0 && options.span_days < static_cast<uint64_t>(period_days)) period_days = static_cast<int64_t>(options.span_days);
+}
+
+WeatherDay ForecastGenerator::at(uint64_t index) const {
+    DayRandom random(options.seed, index);
+    uint64_t date_index = index / options.stations;
+    uint32_t station = index % options.stations;
+    // floor(i * (1 - ratio)) совпадает у соседних номеров ровно для доли ratio дней
+    int64_t offset = static_cast<int64_t>(static_cast<double>(date_index) * (1.0 - options.duplicate_ratio));
+    offset %= period_days;
+    chrono::year_month_day ymd{chrono::sys_days(chrono::days(start_day + offset))};
+    Date date(static_cast<unsigned>(ymd.day()), static_cast<unsigned>(ymd.month()), static_cast<int>(ymd.year()));
+
+    double day_of_year = (static_cast<unsigned>(ymd.month()) - 1) * 30.44 + static_cast<unsigned>(ymd.day());
+    double season = cos(2 * numbers::pi * (day_of_year - 15) / 365.25);
+    int climate = station == 0 ? 0 : DayRandom(options.seed, ~uint64_t(station)).between(-5, 5);
+    int base = options.mean_temperature + climate - static_cast<int>(lround(options.seasonal_amplitude * season));
+
+    int temperatures[3] = {base - 3 + random.between(-4, 4), base + 3 + random.between(-4, 4), base + random.between(-4, 4)};
+    // День с морозом считается снежным, и check() требует, чтобы оттепели в нём не было
+    if (ranges::min(temperatures) < 0) {
+        for (int& temperature : temperatures) temperature = min(temperature, 0);
+    }
+    if (random.uniform() < options.error_ratio) temperatures[0] = 61 + random.between(0, 39);
+    Weather morning, noon, evening;
+    morning.setTemperature(temperatures[0]);
+    noon.setTemperature(temperatures[1]);
+    evening.setTemperature(temperatures[2]);
+
+    double precipitation = random.uniform() < 0.5 ? 0.0 : random.between(1, 300) / 10.0;
+    PartsOfDay parts;
+    parts.setMorning(morning);
+    parts.setDay(noon);
+    parts.setEvening(evening);
+    return WeatherDay(date, precipitation, parts);
+}
+
+void ForecastGenerator::fill(uint64_t first, span<WeatherDay> out) const {
+    for (size_t i = 0; i != out.size(); i++) out[i] = at(first + i);
+}
+
+vector<WeatherDay> ForecastGenerator::generate(uint64_t first, size_t count) const {
+    vector<WeatherDay> days(count);
+    fill(first, days);
+    return days;
+}
+
+Forecast ForecastGenerator::makeForecast(size_t count, bool shuffled) const {
+    vector<WeatherDay> days = generate(0, count);
+    if (shuffled) std::shuffle(days.begin(), days.end(), mt19937_64(options.seed));
+    Forecast result;
+    result.append(days);
+    return result;
+}
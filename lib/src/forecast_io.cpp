@@ -0,0 +1,206 @@
+#include "forecast_io.hpp"
+#include "trace.hpp"
+#include "logging.hpp"
+
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+using namespace std;
+
+namespace {
+    constexpr size_t IMPORT_BATCH = 4096; ///< Размер пачки дней, добавляемой одним вызовом append
+
+    /**
+     * @brief Последовательный разбор полей строки без исключений.
+     */
+    class FieldReader {
+    private:
+        const char* pos;
+        const char* end;
+
+        void skipSpaces() {
+            while (pos != end && isspace(static_cast<unsigned char>(*pos))) ++pos;
+        }
+
+    public:
+        explicit FieldReader(string_view line): pos(line.data()), end(line.data() + line.size()) {}
+
+        template <typename Number>
+        bool read(Number& value) {
+            skipSpaces();
+            auto [next, error] = from_chars(pos, end, value);
+            if (error != errc()) return false;
+            pos = next;
+            return true;
+        }
+
+        bool expect(char symbol) {
+            if (pos == end || *pos != symbol) return false;
+            ++pos;
+            return true;
+        }
+
+        bool atEnd() {
+            skipSpaces();
+            return pos == end;
+        }
+    };
+}
+
+Expected<WeatherDay> parseWeatherDay(string_view line) {
+    FieldReader fields(line);
+    int day, month, year, morning, noon, evening;
+    double precipitation;
+    if (!fields.read(day) || !fields.expect('.') || !fields.read(month) || !fields.expect('.') || !fields.read(year)
+        || !fields.read(precipitation) || !fields.read(morning) || !fields.read(noon) || !fields.read(evening)
+        || !fields.atEnd()) {
+        return unexpected(WeatherError::ParseError);
+    }
+    // from_chars принимает "nan" и "inf"
+    if (!isfinite(precipitation)) return unexpected(WeatherError::InvalidPrecipitation);
+    if (day < 0) return unexpected(WeatherError::InvalidDay);
+    if (month < 0) return unexpected(WeatherError::InvalidMonth);
+    Expected<Date> date = Date::tryMake(day, month, year);
+    if (!date) return unexpected(date.error());
+    Expected<Weather> morning_weather = Weather::tryMake(morning);
+    Expected<Weather> noon_weather = Weather::tryMake(noon);
+    Expected<Weather> evening_weather = Weather::tryMake(evening);
+    if (!morning_weather || !noon_weather || !evening_weather) return unexpected(WeatherError::InvalidTemperature);
+    PartsOfDay parts;
+    parts.setMorning(*morning_weather);
+    parts.setDay(*noon_weather);
+    parts.setEvening(*evening_weather);
+    return WeatherDay::tryMake(*date, precipitation, parts);
+}
+
+char* formatWeatherDay(const WeatherDay& day, char* out) {
+    char* end = out + MAX_RECORD_LENGTH;
+    auto twoDigits = [&out](uint32_t value) {
+        if (value < 10) *out++ = '0';
+        out = to_chars(out, out + 10, value).ptr;
+    };
+    Date date = day.getDate();
+    PartsOfDay parts = day.getPartsOfDay();
+    twoDigits(date.getDay());
+    *out++ = '.';
+    twoDigits(date.getMonth());
+    *out++ = '.';
+    out = to_chars(out, end, date.getYear()).ptr;
+    *out++ = ' ';
+    out = to_chars(out, end, day.getPrecipitation()).ptr;
+    for (int temperature : {parts.getMorning().getTemperature(), parts.getDay().getTemperature(), parts.getEvening().getTemperature()}) {
+        *out++ = ' ';
+        out = to_chars(out, end, temperature).ptr;
+    }
+    return out;
+}
+
+ImportResult importForecast(istream& in, Forecast& obj, stop_token token) {
+    TraceSpan trace_span("importForecast", "io");
+    ImportResult result;
+    vector<WeatherDay> batch;
+    batch.reserve(IMPORT_BATCH);
+    string line;
+    while (!token.stop_requested() && getline(in, line)) {
+        if (line.find_first_not_of(" \t\r") == string::npos) continue;
+        Expected<WeatherDay> day = parseWeatherDay(line);
+        if (!day) {
+            logMessage<LogLevel::Debug>(LogCategory::Io, "rejected record \"", line, "\": ", errorMessage(day.error()));
+            result.rejected++;
+            continue;
+        }
+        batch.push_back(*day);
+        if (batch.size() == IMPORT_BATCH) {
+            obj.append(batch);
+            result.imported += batch.size();
+            batch.clear();
+        }
+    }
+    obj.append(batch);
+    result.imported += batch.size();
+    logMessage<LogLevel::Debug>(LogCategory::Io, "imported ", result.imported, " records, rejected ", result.rejected);
+    return result;
+}
+
+BinaryRecord toBinaryRecord(const WeatherDay& day) {
+    BinaryRecord record{};
+    Date date = day.getDate();
+    PartsOfDay parts = day.getPartsOfDay();
+    record.precipitation = day.getPrecipitation();
+    record.year = date.getYear();
+    record.morning = parts.getMorning().getTemperature();
+    record.noon = parts.getDay().getTemperature();
+    record.evening = parts.getEvening().getTemperature();
+    record.day = static_cast<uint8_t>(date.getDay());
+    record.month = static_cast<uint8_t>(date.getMonth());
+    record.phenomen = static_cast<uint8_t>(day.getPhenomen());
+    return record;
+}
+
+Expected<WeatherDay> fromBinaryRecord(const BinaryRecord& record) {
+    Expected<Date> date = Date::tryMake(record.day, record.month, record.year);
+    if (!date) return unexpected(date.error());
+    if (!isfinite(record.precipitation)) return unexpected(WeatherError::InvalidPrecipitation);
+    Expected<Weather> morning = Weather::tryMake(record.morning);
+    Expected<Weather> noon = Weather::tryMake(record.noon);
+    Expected<Weather> evening = Weather::tryMake(record.evening);
+    if (!morning || !noon || !evening) return unexpected(WeatherError::InvalidTemperature);
+    if (record.phenomen < static_cast<uint8_t>(Phenomen::Sunny) || record.phenomen > static_cast<uint8_t>(Phenomen::Snowy)) {
+        return unexpected(WeatherError::ParseError);
+    }
+    PartsOfDay parts;
+    parts.setMorning(*morning);
+    parts.setDay(*noon);
+    parts.setEvening(*evening);
+    Expected<WeatherDay> result = WeatherDay::tryMake(*date, record.precipitation, parts);
+    if (result) result->setPhenomen(static_cast<Phenomen>(record.phenomen));
+    return result;
+}
+
+ImportResult importBinaryForecast(istream& in, Forecast& obj) {
+    TraceSpan trace_span("importBinaryForecast", "io");
+    BinaryHeader header;
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)) || memcmp(header.magic, BINARY_MAGIC, sizeof(BINARY_MAGIC)) != 0) {
+        throw runtime_error("INVALID BINARY HEADER\n");
+    }
+    ImportResult result;
+    vector<BinaryRecord> records(IMPORT_BATCH);
+    vector<WeatherDay> batch;
+    batch.reserve(IMPORT_BATCH);
+    uint64_t left = header.count;
+    while (left != 0 && in) {
+        size_t wanted = static_cast<size_t>(min<uint64_t>(left, IMPORT_BATCH));
+        in.read(reinterpret_cast<char*>(records.data()), wanted * sizeof(BinaryRecord));
+        size_t got = static_cast<size_t>(in.gcount()) / sizeof(BinaryRecord);
+        for (size_t i = 0; i != got; i++) {
+            Expected<WeatherDay> day = fromBinaryRecord(records[i]);
+            if (day) batch.push_back(*day);
+            else result.rejected++;
+        }
+        obj.append(batch);
+        result.imported += batch.size();
+        batch.clear();
+        left -= got;
+    }
+    if (left != 0) {
+        logMessage<LogLevel::Warning>(LogCategory::Io, "binary file truncated: ", left, " of ", header.count, " records missing");
+    }
+    return result;
+}
+
+bool importForecastFromFile(const string& filename, Forecast& obj) {
+    ifstream file(filename);
+    if (!file.is_open()) {
+        return false;
+    }
+    importForecast(file, obj);
+    if (file.bad()) {
+        return false;
+    }
+    return true;
+}
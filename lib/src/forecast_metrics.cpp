@@ -0,0 +1,61 @@
+#include "forecast_metrics.hpp"
+
+using namespace std;
+
+namespace detail {
+    array<MetricSlot, METRIC_COUNT> metric_slots;
+}
+
+MetricsSnapshot metricsSnapshot() {
+    MetricsSnapshot snapshot;
+    for (size_t i = 0; i != METRIC_COUNT; i++) {
+        snapshot.values[i] = detail::metric_slots[i].value.load(memory_order_relaxed);
+    }
+    return snapshot;
+}
+
+void resetMetrics() {
+    for (detail::MetricSlot& slot : detail::metric_slots) slot.value.store(0, memory_order_relaxed);
+}
+
+const char* metricName(Metric metric) {
+    switch (metric) {
+        case Metric::Resizes:             return "resizes";
+        case Metric::ResizeBytesCopied:   return "resize_bytes_copied";
+        case Metric::Detaches:            return "detaches";
+        case Metric::DetachBytesCopied:   return "detach_bytes_copied";
+        case Metric::DeleteShifts:        return "delete_shifts";
+        case Metric::ScannedColdestDay:   return "scanned_coldest_day";
+        case Metric::ScannedColdestDays:  return "scanned_coldest_days";
+        case Metric::ScannedNextSunnyDay: return "scanned_next_sunny_day";
+        case Metric::ScannedDaysOfMonth:  return "scanned_days_of_month";
+        case Metric::CacheHits:           return "cache_hits";
+        case Metric::CacheMisses:         return "cache_misses";
+        case Metric::Sorts:               return "sorts";
+        default:                          return "unknown";
+    }
+}
+
+string formatMetricsText(const MetricsSnapshot& snapshot) {
+    string result;
+    for (size_t i = 0; i != METRIC_COUNT; i++) {
+        result += metricName(static_cast<Metric>(i));
+        result += ' ';
+        result += to_string(snapshot.values[i]);
+        result += '\n';
+    }
+    return result;
+}
+
+string formatMetricsJson(const MetricsSnapshot& snapshot) {
+    string result = METRICS_ENABLED ? "{\"enabled\":true,\"counters\":{" : "{\"enabled\":false,\"counters\":{";
+    for (size_t i = 0; i != METRIC_COUNT; i++) {
+        if (i != 0) result += ',';
+        result += '"';
+        result += metricName(static_cast<Metric>(i));
+        result += "\":";
+        result += to_string(snapshot.values[i]);
+    }
+    result += "}}";
+    return result;
+}
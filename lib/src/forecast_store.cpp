@@ -0,0 +1,135 @@
+#include "forecast_store.hpp"
+
+#include <future>
+#include <mutex>
+#include <utility>
+
+using namespace std;
+
+ForecastStore::ForecastStore(size_t shard_count) {
+    if (shard_count == 0) throw invalid_argument("INVALID SHARD COUNT\n");
+    shards.reserve(shard_count);
+    for (size_t i = 0; i != shard_count; i++) shards.push_back(make_unique<Shard>());
+}
+
+ForecastStore::Shard& ForecastStore::shardFor(const string& station) const {
+    return *shards[hash<string>{}(station) % shards.size()];
+}
+
+void ForecastStore::add(const string& station, const WeatherDay& day) {
+    append(station, span<const WeatherDay>(&day, 1));
+}
+
+void ForecastStore::append(const string& station, span<const WeatherDay> days) {
+    Shard& shard = shardFor(station);
+    unique_lock<shared_mutex> guard(shard.lock);
+    shard.stations[station].append(days);
+}
+
+void ForecastStore::update(const string& station, const function<void(Forecast&)>& action) {
+    Shard& shard = shardFor(station);
+    unique_lock<shared_mutex> guard(shard.lock);
+    action(shard.stations[station]);
+}
+
+bool ForecastStore::removeStation(const string& station) {
+    Shard& shard = shardFor(station);
+    unique_lock<shared_mutex> guard(shard.lock);
+    return shard.stations.erase(station) != 0;
+}
+
+bool ForecastStore::contains(const string& station) const {
+    Shard& shard = shardFor(station);
+    shared_lock<shared_mutex> guard(shard.lock);
+    return shard.stations.contains(station);
+}
+
+Forecast ForecastStore::getForecast(const string& station) const {
+    Shard& shard = shardFor(station);
+    shared_lock<shared_mutex> guard(shard.lock);
+    auto found = shard.stations.find(station);
+    if (found == shard.stations.end()) throw out_of_range("UNKNOWN STATION");
+    return found->second;
+}
+
+size_t ForecastStore::getStationCount() const {
+    size_t total = 0;
+    for (const auto& shard : shards) {
+        shared_lock<shared_mutex> guard(shard->lock);
+        total += shard->stations.size();
+    }
+    return total;
+}
+
+size_t ForecastStore::getShardCount() const {
+    return shards.size();
+}
+
+map<string, WeatherDay> ForecastStore::collectPerStation(
+    const function<bool(const Forecast&, WeatherDay&)>& action) const {
+    vector<future<vector<pair<string, WeatherDay>>>> tasks;
+    tasks.reserve(shards.size());
+    for (const auto& shard : shards) {
+        tasks.push_back(async(launch::async, [&shard, &action]() {
+            vector<pair<string, Forecast>> copies;
+            {
+                shared_lock<shared_mutex> guard(shard->lock);
+                copies.reserve(shard->stations.size());
+                for (const auto& [station, forecast] : shard->stations) copies.emplace_back(station, forecast);
+            }
+            vector<pair<string, WeatherDay>> found;
+            for (const auto& [station, forecast] : copies) {
+                WeatherDay day;
+                if (action(forecast, day)) found.emplace_back(station, day);
+            }
+            return found;
+        }));
+    }
+    map<string, WeatherDay> result;
+    for (auto& task : tasks) {
+        for (auto& [station, day] : task.get()) result.emplace(std::move(station), day);
+    }
+    return result;
+}
+
+map<string, WeatherDay> ForecastStore::findColdestDays(const Date& from, const Date& to) const {
+    return collectPerStation([&from, &to](const Forecast& forecast, WeatherDay& day) {
+        if (forecast.getCount() == 0) return false;
+        try {
+            day = forecast.findColdestDay(from, to);
+        } catch (const runtime_error&) {
+            return false;
+        }
+        return true;
+    });
+}
+
+map<string, WeatherDay> ForecastStore::findNextSunnyDays(const Date& today) const {
+    return collectPerStation([&today](const Forecast& forecast, WeatherDay& day) {
+        if (forecast.getCount() == 0) return false;
+        try {
+            day = forecast.findNextSunnyDay(today);
+        } catch (const runtime_error&) {
+            return false;
+        }
+        return true;
+    });
+}
+
+vector<ShardUsage> ForecastStore::memoryUsage() const {
+    vector<ShardUsage> usage;
+    usage.reserve(shards.size());
+    for (const auto& shard : shards) {
+        shared_lock<shared_mutex> guard(shard->lock);
+        ShardUsage entry{shard->stations.size(), 0, sizeof(Shard)};
+        entry.bytes += shard->stations.bucket_count() * sizeof(void*);
+        for (const auto& [station, forecast] : shard->stations) {
+            entry.days += forecast.getCount();
+            entry.bytes += sizeof(pair<const string, Forecast>) + 2 * sizeof(void*);
+            if (station.capacity() > string().capacity()) entry.bytes += station.capacity() + 1;
+            entry.bytes += forecast.memoryUsage().totalBytes();
+        }
+        usage.push_back(entry);
+    }
+    return usage;
+}
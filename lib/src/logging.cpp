@@ -0,0 +1,68 @@
+#include "logging.hpp"
+
+#include <array>
+#include <iostream>
+#include <mutex>
+#include <string>
+
+using namespace std;
+
+namespace {
+    mutex sinks_lock;
+    array<LogSink, static_cast<size_t>(LogCategory::Count)> sinks = []() {
+        array<LogSink, static_cast<size_t>(LogCategory::Count)> defaults;
+        defaults.fill(stderrLogSink());
+        return defaults;
+    }();
+}
+
+void setLogSink(LogCategory category, LogSink sink) {
+    lock_guard<mutex> guard(sinks_lock);
+    sinks[static_cast<size_t>(category)] = std::move(sink);
+}
+
+LogSink stderrLogSink() {
+    return [](LogLevel level, LogCategory category, string_view message) {
+        while (!message.empty() && message.back() == '\n') message.remove_suffix(1);
+        string line = string("[") + logLevelName(level) + "] [" + logCategoryName(category) + "] ";
+        line += message;
+        line += '\n';
+        cerr << line;
+    };
+}
+
+const char* logLevelName(LogLevel level) {
+    switch (level) {
+        case LogLevel::Trace:   return "TRACE";
+        case LogLevel::Debug:   return "DEBUG";
+        case LogLevel::Info:    return "INFO";
+        case LogLevel::Warning: return "WARNING";
+        case LogLevel::Error:   return "ERROR";
+        default:                return "OFF";
+    }
+}
+
+const char* logCategoryName(LogCategory category) {
+    switch (category) {
+        case LogCategory::Forecast: return "forecast";
+        case LogCategory::Query:    return "query";
+        case LogCategory::Io:       return "io";
+        default:                    return "unknown";
+    }
+}
+
+namespace detail {
+    bool hasLogSink(LogCategory category) {
+        lock_guard<mutex> guard(sinks_lock);
+        return static_cast<bool>(sinks[static_cast<size_t>(category)]);
+    }
+
+    void writeLog(LogLevel level, LogCategory category, string_view message) {
+        LogSink sink;
+        {
+            lock_guard<mutex> guard(sinks_lock);
+            sink = sinks[static_cast<size_t>(category)];
+        }
+        if (sink) sink(level, category, message);
+    }
+}
@@ -0,0 +1,160 @@
+#include "packed_forecast.hpp"
+
+#include <cmath>
+#include <limits>
+
+using namespace std;
+
+Expected<PackedWeatherDay> PackedWeatherDay::tryPack(const WeatherDay& source) {
+    Date date = source.getDate();
+    PartsOfDay parts = source.getPartsOfDay();
+    int temperatures[] = {parts.getMorning().getTemperature(), parts.getDay().getTemperature(), parts.getEvening().getTemperature()};
+    for (int temperature : temperatures) {
+        if (temperature > numeric_limits<int16_t>::max()) return unexpected(WeatherError::NotRepresentable);
+    }
+    int phenomen = static_cast<int>(source.getPhenomen());
+    if (phenomen < static_cast<int>(Phenomen::Sunny) || phenomen > static_cast<int>(Phenomen::Snowy)) {
+        return unexpected(WeatherError::NotRepresentable);
+    }
+    double precipitation = source.getPrecipitation();
+    if (!(precipitation <= numeric_limits<uint32_t>::max() / 100.0)) return unexpected(WeatherError::NotRepresentable);
+    uint32_t hundredths = static_cast<uint32_t>(llround(precipitation * 100));
+    if (hundredths / 100.0 != precipitation) return unexpected(WeatherError::NotRepresentable);
+
+    PackedWeatherDay result{};
+    result.precipitation = hundredths;
+    result.year = static_cast<int16_t>(date.getYear());
+    result.morning = static_cast<int16_t>(temperatures[0]);
+    result.noon = static_cast<int16_t>(temperatures[1]);
+    result.evening = static_cast<int16_t>(temperatures[2]);
+    result.day = static_cast<uint8_t>(date.getDay());
+    result.month = static_cast<uint8_t>(date.getMonth());
+    result.phenomen = static_cast<uint8_t>(phenomen);
+    return result;
+}
+
+PackedWeatherDay PackedWeatherDay::pack(const WeatherDay& source) {
+    Expected<PackedWeatherDay> result = tryPack(source);
+    if (!result) throw invalid_argument(errorMessage(result.error()));
+    return *result;
+}
+
+WeatherDay PackedWeatherDay::unpack() const {
+    PartsOfDay parts;
+    Weather weather;
+    weather.setTemperature(morning);
+    parts.setMorning(weather);
+    weather.setTemperature(noon);
+    parts.setDay(weather);
+    weather.setTemperature(evening);
+    parts.setEvening(weather);
+    return WeatherDay(getDate(), precipitation / 100.0, parts, phenomen);
+}
+
+Date PackedWeatherDay::getDate() const {
+    return Date(day, month, year);
+}
+
+int32_t packedDateKey(const Date& date) {
+    PackedWeatherDay key{};
+    key.year = static_cast<int16_t>(date.getYear());
+    key.month = static_cast<uint8_t>(date.getMonth());
+    key.day = static_cast<uint8_t>(date.getDay());
+    return key.dateKey();
+}
+
+PackedForecast::PackedForecast(const Forecast& forecast) {
+    days.reserve(forecast.getCount());
+    for (size_t i = 0; i != forecast.getCount(); i++) *this += forecast[i];
+}
+
+PackedForecast& PackedForecast::operator+=(const WeatherDay& new_day) {
+    days.push_back(PackedWeatherDay::pack(new_day));
+    return *this;
+}
+
+Expected<void> PackedForecast::tryAppend(const WeatherDay& new_day) {
+    Expected<PackedWeatherDay> packed = PackedWeatherDay::tryPack(new_day);
+    if (!packed) return unexpected(packed.error());
+    days.push_back(*packed);
+    return {};
+}
+
+void PackedForecast::reserve(size_t new_capacity) {
+    days.reserve(new_capacity);
+}
+
+WeatherDay PackedForecast::operator[](size_t index) const {
+    if (index >= days.size()) throw out_of_range("INVALID INDEX");
+    return days[index].unpack();
+}
+
+size_t PackedForecast::getCount() const {
+    return days.size();
+}
+
+span<const PackedWeatherDay> PackedForecast::records() const {
+    return days;
+}
+
+size_t PackedForecast::memoryBytes() const {
+    return days.capacity() * sizeof(PackedWeatherDay);
+}
+
+WeatherDay PackedForecast::findColdestDay(const Date& from, const Date& to) const {
+    if (days.empty()) throw invalid_argument("DATA IS EMPTY\n");
+    int32_t from_key = packedDateKey(from);
+    int32_t to_key = packedDateKey(to);
+    const PackedWeatherDay* coldest = nullptr;
+    for (const PackedWeatherDay& day : days) {
+        int32_t key = day.dateKey();
+        if (key <= from_key || key >= to_key) continue;
+        if (coldest == nullptr || day.averageTempOfDay() < coldest->averageTempOfDay()) coldest = &day;
+    }
+    if (coldest == nullptr) throw runtime_error("No day found in the given range");
+    return coldest->unpack();
+}
+
+WeatherDay PackedForecast::findNextSunnyDay(const Date& today) const {
+    if (days.empty()) throw invalid_argument("DATA IS EMPTY");
+    int32_t today_key = packedDateKey(today);
+    const PackedWeatherDay* result = nullptr;
+    for (const PackedWeatherDay& day : days) {
+        if (day.getPhenomen() != Phenomen::Sunny || day.dateKey() <= today_key) continue;
+        if (result == nullptr || day.dateKey() < result->dateKey()) result = &day;
+    }
+    if (result == nullptr) throw runtime_error("No sunny day found after the given date");
+    return result->unpack();
+}
+
+Forecast PackedForecast::giveAllDaysOfMonth(size_t month) const {
+    if (days.empty()) throw invalid_argument("DATA IS EMPTY\n");
+    if (month > 12 || month == 0) throw invalid_argument("INVALID MONTH\n");
+    size_t found = 0;
+    for (const PackedWeatherDay& day : days) {
+        if (day.month == month) found++;
+    }
+    if (found == 0) throw runtime_error("There is no weather forecast for this month.\n");
+    Forecast result(found);
+    for (const PackedWeatherDay& day : days) {
+        if (day.month == month) result += day.unpack();
+    }
+    result.sortDaysByData();
+    return result;
+}
+
+Forecast PackedForecast::toForecast() const {
+    Forecast result(days.empty() ? 1 : days.size());
+    for (const PackedWeatherDay& day : days) result += day.unpack();
+    return result;
+}
+
+ostream& operator<<(std::ostream& os, const PackedForecast& obj) {
+    os << "===========================" << endl;
+    size_t index = 0;
+    for (const PackedWeatherDay& day : obj.days) {
+        os << ++index << "." << day.unpack();
+        os << "===========================" << endl;
+    }
+    return os;
+}
@@ -0,0 +1,93 @@
+#include "rolling_forecast.hpp"
+#include "forecast_queries.hpp"
+
+using namespace std;
+
+RollingForecast::RollingForecast(size_t capacity): head(0), count(0) {
+    if (capacity == 0) throw invalid_argument("INVALID CAPACITY\n");
+    days.resize(capacity);
+}
+
+RollingForecast& RollingForecast::operator+=(const WeatherDay& new_day) {
+    size_t capacity = days.size();
+    if (count == capacity) {
+        days[head] = new_day;
+        head = head + 1 == capacity ? 0 : head + 1;
+        return *this;
+    }
+    size_t tail = head + count;
+    days[tail < capacity ? tail : tail - capacity] = new_day;
+    count++;
+    return *this;
+}
+
+const WeatherDay& RollingForecast::operator[](size_t index) const {
+    if (index >= count) throw out_of_range("INVALID INDEX");
+    size_t position = head + index;
+    return days[position < days.size() ? position : position - days.size()];
+}
+
+size_t RollingForecast::getCount() const {
+    return count;
+}
+
+size_t RollingForecast::getCapacity() const {
+    return days.size();
+}
+
+bool RollingForecast::isFull() const {
+    return count == days.size();
+}
+
+void RollingForecast::clear() {
+    head = 0;
+    count = 0;
+}
+
+array<span<const WeatherDay>, 2> RollingForecast::segments() const {
+    span<const WeatherDay> buffer(days);
+    size_t first = min(count, days.size() - head);
+    return {buffer.subspan(head, first), buffer.first(count - first)};
+}
+
+WeatherDay RollingForecast::findColdestDay(const Date& from, const Date& to) const {
+    if (count == 0) throw invalid_argument("DATA IS EMPTY\n");
+    const WeatherDay* result = findColdestDayIn(segments(), from, to);
+    if (result == nullptr) throw runtime_error("No day found in the given range");
+    return *result;
+}
+
+WeatherDay RollingForecast::findNextSunnyDay(const Date& today) const {
+    if (count == 0) throw invalid_argument("DATA IS EMPTY");
+    const WeatherDay* result = findNextSunnyDayIn(segments(), today);
+    if (result == nullptr) throw runtime_error("No sunny day found after the given date");
+    return *result;
+}
+
+Forecast RollingForecast::giveAllDaysOfMonth(size_t month) const {
+    if (count == 0) throw invalid_argument("DATA IS EMPTY\n");
+    if (month > 12 || month == 0) throw invalid_argument("INVALID MONTH\n");
+    Forecast result = collectDaysOfMonthIn(segments(), month);
+    if (result.getCount() == 0) throw runtime_error("There is no weather forecast for this month.\n");
+    return result;
+}
+
+Forecast RollingForecast::toForecast() const {
+    Forecast result(count == 0 ? 1 : count);
+    for (span<const WeatherDay> segment : segments()) {
+        for (const WeatherDay& day : segment) result += day;
+    }
+    return result;
+}
+
+ostream& operator<<(std::ostream& os, const RollingForecast& obj) {
+    os << "===========================" << endl;
+    size_t index = 0;
+    for (span<const WeatherDay> segment : obj.segments()) {
+        for (const WeatherDay& day : segment) {
+            os << ++index << "." << day;
+            os << "===========================" << endl;
+        }
+    }
+    return os;
+}
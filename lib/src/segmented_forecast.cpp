@@ -0,0 +1,145 @@
+#include "segmented_forecast.hpp"
+#include "forecast_queries.hpp"
+
+#include <algorithm>
+#include <bit>
+
+using namespace std;
+
+SegmentedForecast::SegmentedForecast(size_t new_chunk_size): chunk_size(new_chunk_size), count(0) {
+    if (!has_single_bit(new_chunk_size)) throw invalid_argument("INVALID CHUNK SIZE\n");
+    chunk_shift = countr_zero(new_chunk_size);
+}
+
+SegmentedForecast::SegmentedForecast(const Forecast& forecast, size_t new_chunk_size):
+    SegmentedForecast(new_chunk_size) {
+    for (size_t i = 0; i != forecast.getCount(); i++) *this += forecast[i];
+}
+
+SegmentedForecast::SegmentedForecast(const SegmentedForecast& other):
+    chunk_size(other.chunk_size), chunk_shift(other.chunk_shift), count(other.count) {
+    chunks.reserve(other.chunks.size());
+    for (size_t i = 0; i != other.chunks.size(); i++) {
+        chunks.push_back(make_unique<WeatherDay[]>(chunk_size));
+        size_t used = min(chunk_size, count - i * chunk_size);
+        copy_n(other.chunks[i].get(), used, chunks.back().get());
+    }
+}
+
+SegmentedForecast::SegmentedForecast(SegmentedForecast&& other) noexcept:
+    chunks(std::move(other.chunks)), chunk_size(other.chunk_size), chunk_shift(other.chunk_shift), count(other.count) {
+    other.chunks.clear();
+    other.count = 0;
+}
+
+SegmentedForecast& SegmentedForecast::operator=(SegmentedForecast&& other) noexcept {
+    if (this == &other) return *this;
+    chunks = std::move(other.chunks);
+    chunk_size = other.chunk_size;
+    chunk_shift = other.chunk_shift;
+    count = other.count;
+    other.chunks.clear();
+    other.count = 0;
+    return *this;
+}
+
+SegmentedForecast& SegmentedForecast::operator=(const SegmentedForecast& other) {
+    if (this == &other) return *this;
+    SegmentedForecast copy(other);
+    *this = std::move(copy);
+    return *this;
+}
+
+SegmentedForecast& SegmentedForecast::operator+=(const WeatherDay& new_day) {
+    if (count == chunks.size() * chunk_size) chunks.push_back(make_unique<WeatherDay[]>(chunk_size));
+    chunks[count >> chunk_shift][count & (chunk_size - 1)] = new_day;
+    count++;
+    return *this;
+}
+
+WeatherDay& SegmentedForecast::operator[](size_t index) {
+    if (index >= count) throw out_of_range("INVALID INDEX");
+    return chunks[index >> chunk_shift][index & (chunk_size - 1)];
+}
+
+const WeatherDay& SegmentedForecast::operator[](size_t index) const {
+    if (index >= count) throw out_of_range("INVALID INDEX");
+    return chunks[index >> chunk_shift][index & (chunk_size - 1)];
+}
+
+size_t SegmentedForecast::getCount() const {
+    return count;
+}
+
+size_t SegmentedForecast::getChunkSize() const {
+    return chunk_size;
+}
+
+size_t SegmentedForecast::getChunkCount() const {
+    return chunks.size();
+}
+
+vector<span<const WeatherDay>> SegmentedForecast::segments() const {
+    vector<span<const WeatherDay>> result;
+    result.reserve(chunks.size());
+    for (size_t i = 0; i != chunks.size(); i++) {
+        size_t used = min(chunk_size, count - i * chunk_size);
+        if (used == 0) break;
+        result.emplace_back(chunks[i].get(), used);
+    }
+    return result;
+}
+
+void SegmentedForecast::deleteAllErrors() {
+    size_t kept = 0;
+    for (size_t i = 0; i != count; i++) {
+        const WeatherDay& day = chunks[i >> chunk_shift][i & (chunk_size - 1)];
+        if (!day.check()) continue;
+        if (kept != i) chunks[kept >> chunk_shift][kept & (chunk_size - 1)] = day;
+        kept++;
+    }
+    count = kept;
+    chunks.resize((count + chunk_size - 1) >> chunk_shift);
+}
+
+WeatherDay SegmentedForecast::findColdestDay(const Date& from, const Date& to) const {
+    if (count == 0) throw invalid_argument("DATA IS EMPTY\n");
+    const WeatherDay* result = findColdestDayIn(segments(), from, to);
+    if (result == nullptr) throw runtime_error("No day found in the given range");
+    return *result;
+}
+
+WeatherDay SegmentedForecast::findNextSunnyDay(const Date& today) const {
+    if (count == 0) throw invalid_argument("DATA IS EMPTY");
+    const WeatherDay* result = findNextSunnyDayIn(segments(), today);
+    if (result == nullptr) throw runtime_error("No sunny day found after the given date");
+    return *result;
+}
+
+Forecast SegmentedForecast::giveAllDaysOfMonth(size_t month) const {
+    if (count == 0) throw invalid_argument("DATA IS EMPTY\n");
+    if (month > 12 || month == 0) throw invalid_argument("INVALID MONTH\n");
+    Forecast result = collectDaysOfMonthIn(segments(), month);
+    if (result.getCount() == 0) throw runtime_error("There is no weather forecast for this month.\n");
+    return result;
+}
+
+Forecast SegmentedForecast::toForecast() const {
+    Forecast result(count == 0 ? 1 : count);
+    for (span<const WeatherDay> segment : segments()) {
+        for (const WeatherDay& day : segment) result += day;
+    }
+    return result;
+}
+
+ostream& operator<<(std::ostream& os, const SegmentedForecast& obj) {
+    os << "===========================" << endl;
+    size_t index = 0;
+    for (span<const WeatherDay> segment : obj.segments()) {
+        for (const WeatherDay& day : segment) {
+            os << ++index << "." << day;
+            os << "===========================" << endl;
+        }
+    }
+    return os;
+}
@@ -0,0 +1,321 @@
+#include "shared_forecast.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+namespace {
+
+constexpr uint64_t MAGIC = 0x31304d4853434657; ///< "WFCSHM01" — формат сегмента
+
+/**
+ * @brief Заголовок сегмента; лежит в начале отображения.
+ */
+struct alignas(64) Header {
+    uint64_t magic;                     ///< MAGIC после инициализации
+    uint64_t capacity;                  ///< Ёмкость каждого буфера в днях
+    atomic<uint64_t> sequence;          ///< 2k — k публикаций завершено, 2k - 1 — идёт k-я
+    atomic<uint64_t> count[2];          ///< Количество дней в каждом буфере
+};
+
+static_assert(atomic<uint64_t>::is_always_lock_free, "shared memory needs address-free atomics");
+
+/**
+ * @brief Указатели на столбцы одного буфера.
+ */
+struct Columns {
+    double* precipitation;
+    int32_t* year;
+    uint32_t* month;
+    uint32_t* day;
+    int32_t* average;   ///< WeatherDay::averageTempOfDay()
+    int32_t* morning;
+    int32_t* noon;
+    int32_t* evening;
+    uint32_t* phenomen;
+};
+
+/**
+ * @brief Одна строка, скопированная из столбцов.
+ */
+struct RawDay {
+    double precipitation;
+    int32_t year;
+    uint32_t month;
+    uint32_t day;
+    int32_t morning;
+    int32_t noon;
+    int32_t evening;
+    uint32_t phenomen;
+};
+
+constexpr size_t ROW_BYTES = sizeof(double) + 8 * sizeof(uint32_t);
+
+size_t bufferBytes(size_t capacity) {
+    return (capacity * ROW_BYTES + 63) / 64 * 64;
+}
+
+size_t segmentBytes(size_t capacity) {
+    return sizeof(Header) + 2 * bufferBytes(capacity);
+}
+
+Columns columnsOf(char* base, size_t capacity, size_t buffer) {
+    char* next = base + sizeof(Header) + buffer * bufferBytes(capacity);
+    auto take = [&next, capacity](auto* column) {
+        using Element = remove_pointer_t<decltype(column)>;
+        column = reinterpret_cast<Element*>(next);
+        next += capacity * sizeof(Element);
+        return column;
+    };
+    Columns columns{};
+    columns.precipitation = take(columns.precipitation);
+    columns.year = take(columns.year);
+    columns.month = take(columns.month);
+    columns.day = take(columns.day);
+    columns.average = take(columns.average);
+    columns.morning = take(columns.morning);
+    columns.noon = take(columns.noon);
+    columns.evening = take(columns.evening);
+    columns.phenomen = take(columns.phenomen);
+    return columns;
+}
+
+RawDay rowAt(const Columns& columns, size_t index) {
+    return {columns.precipitation[index], columns.year[index], columns.month[index], columns.day[index],
+            columns.morning[index], columns.noon[index], columns.evening[index], columns.phenomen[index]};
+}
+
+// Сравнение даты строки index с датой other: <0, 0, >0
+int compareDate(const Columns& columns, size_t index, const Date& other) {
+    if (columns.year[index] != other.getYear()) return columns.year[index] < other.getYear() ? -1 : 1;
+    if (columns.month[index] != other.getMonth()) return columns.month[index] < other.getMonth() ? -1 : 1;
+    if (columns.day[index] != other.getDay()) return columns.day[index] < other.getDay() ? -1 : 1;
+    return 0;
+}
+
+// Сравнение дат строк first и second без создания Date: <0, 0, >0
+int compareRows(const Columns& columns, size_t first, size_t second) {
+    if (columns.year[first] != columns.year[second]) return columns.year[first] < columns.year[second] ? -1 : 1;
+    if (columns.month[first] != columns.month[second]) return columns.month[first] < columns.month[second] ? -1 : 1;
+    if (columns.day[first] != columns.day[second]) return columns.day[first] < columns.day[second] ? -1 : 1;
+    return 0;
+}
+
+WeatherDay toWeatherDay(const RawDay& raw) {
+    Weather morning, noon, evening;
+    morning.setTemperature(raw.morning);
+    noon.setTemperature(raw.noon);
+    evening.setTemperature(raw.evening);
+    PartsOfDay parts;
+    parts.setMorning(morning);
+    parts.setDay(noon);
+    parts.setEvening(evening);
+    return WeatherDay(Date(raw.day, raw.month, raw.year), raw.precipitation, parts, static_cast<int>(raw.phenomen));
+}
+
+/**
+ * @brief Выполняет запрос по текущему буферу и повторяет его, если писатель успел этот буфер перезаписать.
+ *
+ * query(columns, count) может прочитать частично записанные данные; результат
+ * используется только после успешной проверки sequence, поэтому query не
+ * должен выбрасывать исключений и создавать объекты с проверкой аргументов.
+ */
+template <typename Query>
+auto readConsistent(const void* base, Query query) {
+    const Header& header = *static_cast<const Header*>(base);
+    char* bytes = const_cast<char*>(static_cast<const char*>(base));
+    while (true) {
+        uint64_t sequence = header.sequence.load(memory_order_acquire);
+        uint64_t published = sequence / 2;
+        size_t buffer = published % 2;
+        size_t count = min<uint64_t>(header.count[buffer].load(memory_order_relaxed), header.capacity);
+        auto result = query(columnsOf(bytes, header.capacity, buffer), count);
+        atomic_thread_fence(memory_order_acquire);
+        if (header.sequence.load(memory_order_relaxed) < published * 2 + 3) return result;
+    }
+}
+
+void* mapSegment(int fd, size_t size, int protection) {
+    void* address = mmap(nullptr, size, protection, MAP_SHARED, fd, 0);
+    return address == MAP_FAILED ? nullptr : address;
+}
+
+runtime_error systemError(const string& what) {
+    return runtime_error(what + ": " + strerror(errno) + "\n");
+}
+
+}
+
+SharedForecastPublisher::SharedForecastPublisher(const string& segment_name, size_t max_days):
+    name(segment_name), base(nullptr), size(segmentBytes(max_days)), capacity(max_days) {
+    if (max_days == 0) throw invalid_argument("INVALID CAPACITY\n");
+    shm_unlink(name.c_str());
+    int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd == -1) throw systemError("shm_open");
+    if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        runtime_error error = systemError("ftruncate");
+        close(fd);
+        shm_unlink(name.c_str());
+        throw error;
+    }
+    base = mapSegment(fd, size, PROT_READ | PROT_WRITE);
+    close(fd);
+    if (base == nullptr) {
+        runtime_error error = systemError("mmap");
+        shm_unlink(name.c_str());
+        throw error;
+    }
+    Header* header = new (base) Header;
+    header->capacity = capacity;
+    header->sequence.store(0, memory_order_relaxed);
+    header->count[0].store(0, memory_order_relaxed);
+    header->count[1].store(0, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    header->magic = MAGIC;
+}
+
+SharedForecastPublisher::~SharedForecastPublisher() {
+    munmap(base, size);
+    shm_unlink(name.c_str());
+}
+
+void SharedForecastPublisher::publish(const Forecast& forecast) {
+    if (forecast.getCount() > capacity) throw invalid_argument("FORECAST EXCEEDS SEGMENT CAPACITY\n");
+    // Без надгробий индексы совпадают с позициями в буфере
+    Forecast live = forecast;
+    live.compact();
+
+    Header& header = *static_cast<Header*>(base);
+    uint64_t sequence = header.sequence.load(memory_order_relaxed);
+    size_t buffer = (sequence / 2 + 1) % 2;
+    header.sequence.store(sequence + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+
+    Columns columns = columnsOf(static_cast<char*>(base), capacity, buffer);
+    for (size_t i = 0; i < live.getCount(); i++) {
+        const WeatherDay& day = as_const(live)[i];
+        Date date = day.getDate();
+        PartsOfDay parts = day.getPartsOfDay();
+        columns.precipitation[i] = day.getPrecipitation();
+        columns.year[i] = date.getYear();
+        columns.month[i] = date.getMonth();
+        columns.day[i] = date.getDay();
+        columns.average[i] = day.averageTempOfDay();
+        columns.morning[i] = parts.getMorning().getTemperature();
+        columns.noon[i] = parts.getDay().getTemperature();
+        columns.evening[i] = parts.getEvening().getTemperature();
+        columns.phenomen[i] = static_cast<uint32_t>(day.getPhenomen());
+    }
+    header.count[buffer].store(live.getCount(), memory_order_relaxed);
+    header.sequence.store(sequence + 2, memory_order_release);
+}
+
+uint64_t SharedForecastPublisher::getGeneration() const {
+    return static_cast<const Header*>(base)->sequence.load(memory_order_acquire) / 2;
+}
+
+size_t SharedForecastPublisher::getCapacity() const {
+    return capacity;
+}
+
+SharedForecastReader::SharedForecastReader(const string& segment_name): base(nullptr), size(0) {
+    int fd = shm_open(segment_name.c_str(), O_RDONLY, 0);
+    if (fd == -1) throw systemError("shm_open");
+    struct stat info;
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(Header)) {
+        close(fd);
+        throw runtime_error("INVALID SHARED SEGMENT\n");
+    }
+    size = static_cast<size_t>(info.st_size);
+    base = mapSegment(fd, size, PROT_READ);
+    close(fd);
+    if (base == nullptr) throw systemError("mmap");
+    const Header& header = *static_cast<const Header*>(base);
+    if (header.magic != MAGIC || segmentBytes(header.capacity) != size) {
+        munmap(base, size);
+        throw runtime_error("INVALID SHARED SEGMENT\n");
+    }
+    atomic_thread_fence(memory_order_acquire);
+}
+
+SharedForecastReader::~SharedForecastReader() {
+    munmap(base, size);
+}
+
+uint64_t SharedForecastReader::getGeneration() const {
+    return static_cast<const Header*>(base)->sequence.load(memory_order_acquire) / 2;
+}
+
+size_t SharedForecastReader::getCount() const {
+    return readConsistent(base, [](const Columns&, size_t count) { return count; });
+}
+
+WeatherDay SharedForecastReader::at(size_t index) const {
+    optional<RawDay> found = readConsistent(base, [index](const Columns& columns, size_t count) {
+        return index < count ? optional<RawDay>(rowAt(columns, index)) : nullopt;
+    });
+    if (!found) throw out_of_range("INVALID INDEX");
+    return toWeatherDay(*found);
+}
+
+WeatherDay SharedForecastReader::findColdestDay(const Date& from, const Date& to) const {
+    auto [empty, found] = readConsistent(base, [&from, &to](const Columns& columns, size_t count) {
+        size_t coldest = count;
+        for (size_t i = 0; i < count; i++) {
+            if (compareDate(columns, i, from) <= 0 || compareDate(columns, i, to) >= 0) continue;
+            if (coldest == count || columns.average[i] < columns.average[coldest]) coldest = i;
+        }
+        return pair(count == 0, coldest == count ? nullopt : optional<RawDay>(rowAt(columns, coldest)));
+    });
+    if (empty) throw invalid_argument("DATA IS EMPTY\n");
+    if (!found) throw runtime_error("No day found in the given range");
+    return toWeatherDay(*found);
+}
+
+WeatherDay SharedForecastReader::findNextSunnyDay(const Date& today) const {
+    auto [empty, found] = readConsistent(base, [&today](const Columns& columns, size_t count) {
+        const uint32_t sunny = static_cast<uint32_t>(Phenomen::Sunny);
+        size_t result = count;
+        for (size_t i = 0; i < count; i++) {
+            if (columns.phenomen[i] != sunny || compareDate(columns, i, today) <= 0) continue;
+            if (result == count || compareRows(columns, i, result) < 0) result = i;
+        }
+        return pair(count == 0, result == count ? nullopt : optional<RawDay>(rowAt(columns, result)));
+    });
+    if (empty) throw invalid_argument("DATA IS EMPTY");
+    if (!found) throw runtime_error("No sunny day found after the given date");
+    return toWeatherDay(*found);
+}
+
+Forecast SharedForecastReader::giveAllDaysOfMonth(size_t month) const {
+    if (month > 12 || month == 0) throw invalid_argument("INVALID MONTH\n");
+    auto [empty, rows] = readConsistent(base, [month](const Columns& columns, size_t count) {
+        vector<RawDay> found;
+        for (size_t i = 0; i < count; i++) {
+            if (columns.month[i] == month) found.push_back(rowAt(columns, i));
+        }
+        return pair(count == 0, std::move(found));
+    });
+    if (empty) throw invalid_argument("DATA IS EMPTY\n");
+    if (rows.empty()) throw runtime_error("There is no weather forecast for this month.\n");
+    vector<WeatherDay> days;
+    days.reserve(rows.size());
+    for (const RawDay& raw : rows) days.push_back(toWeatherDay(raw));
+    Forecast result;
+    result.append(days);
+    result.sortDaysByData();
+    return result;
+}
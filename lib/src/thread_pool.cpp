@@ -0,0 +1,103 @@
+#include "thread_pool.hpp"
+
+using namespace std;
+
+namespace {
+    thread_local const ThreadPool* current_pool = nullptr; ///< Пул, которому принадлежит текущий поток
+    thread_local size_t current_worker = 0;                ///< Индекс текущего рабочего потока
+}
+
+ThreadPool::ThreadPool(size_t thread_count): pending(0), next_queue(0), steals(0), stopping(false) {
+    if (thread_count == 0) thread_count = max(1u, thread::hardware_concurrency());
+    workers.reserve(thread_count);
+    for (size_t i = 0; i != thread_count; i++) workers.push_back(make_unique<Worker>());
+    threads.reserve(thread_count);
+    for (size_t i = 0; i != thread_count; i++) threads.emplace_back([this, i]() { workerLoop(i); });
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        lock_guard<mutex> guard(sleep_lock);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (thread& worker : threads) worker.join();
+}
+
+void ThreadPool::submit(function<void()> task) {
+    size_t index = current_pool == this
+        ? current_worker
+        : next_queue.fetch_add(1, memory_order_relaxed) % workers.size();
+    pending.fetch_add(1);
+    {
+        lock_guard<mutex> guard(workers[index]->lock);
+        workers[index]->tasks.push_back(std::move(task));
+    }
+    {
+        lock_guard<mutex> guard(sleep_lock);
+    }
+    wake.notify_one();
+}
+
+bool ThreadPool::popLocal(size_t index, function<void()>& task) {
+    Worker& worker = *workers[index];
+    lock_guard<mutex> guard(worker.lock);
+    if (worker.tasks.empty()) return false;
+    task = std::move(worker.tasks.back());
+    worker.tasks.pop_back();
+    pending.fetch_sub(1);
+    return true;
+}
+
+bool ThreadPool::steal(size_t thief, function<void()>& task) {
+    size_t size = workers.size();
+    size_t start = thief < size ? thief + 1 : 0;
+    for (size_t offset = 0; offset != size; offset++) {
+        size_t victim = (start + offset) % size;
+        if (victim == thief) continue;
+        Worker& worker = *workers[victim];
+        unique_lock<mutex> guard(worker.lock, try_to_lock);
+        if (!guard.owns_lock() || worker.tasks.empty()) continue;
+        task = std::move(worker.tasks.front());
+        worker.tasks.pop_front();
+        pending.fetch_sub(1);
+        steals.fetch_add(1, memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+
+void ThreadPool::workerLoop(size_t index) {
+    current_pool = this;
+    current_worker = index;
+    function<void()> task;
+    while (true) {
+        if (popLocal(index, task) || steal(index, task)) {
+            task();
+            task = nullptr;
+            continue;
+        }
+        unique_lock<mutex> guard(sleep_lock);
+        if (pending.load() != 0) continue;
+        if (stopping) break;
+        wake.wait(guard, [this]() { return stopping || pending.load() != 0; });
+    }
+}
+
+bool ThreadPool::tryRunOne() {
+    function<void()> task;
+    bool found = current_pool == this
+        ? popLocal(current_worker, task) || steal(current_worker, task)
+        : steal(workers.size(), task);
+    if (!found) return false;
+    task();
+    return true;
+}
+
+size_t ThreadPool::getThreadCount() const {
+    return threads.size();
+}
+
+uint64_t ThreadPool::getStealCount() const {
+    return steals.load(memory_order_relaxed);
+}
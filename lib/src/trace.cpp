@@ -0,0 +1,119 @@
+#include "trace.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+using namespace std;
+
+namespace {
+    struct TraceEvent {
+        const char* name;
+        const char* category;
+        int64_t start;
+        int64_t duration;
+    };
+
+    /**
+     * @brief Буфер событий одного потока.
+     *
+     * Мьютекс захватывается владельцем при записи и сборщиком при выгрузке,
+     * поэтому при записи он почти всегда свободен.
+     */
+    struct ThreadBuffer {
+        mutex lock;
+        vector<TraceEvent> events;
+        uint32_t thread_id;
+    };
+
+    atomic<bool> tracing{false};
+    const chrono::steady_clock::time_point trace_epoch = chrono::steady_clock::now();
+
+    // Буферы переживают свои потоки, чтобы события завершившихся потоков попали в выгрузку
+    mutex registry_lock;
+    vector<shared_ptr<ThreadBuffer>> registry;
+
+    ThreadBuffer& threadBuffer() {
+        thread_local shared_ptr<ThreadBuffer> buffer = []() {
+            auto created = make_shared<ThreadBuffer>();
+            lock_guard<mutex> guard(registry_lock);
+            created->thread_id = static_cast<uint32_t>(registry.size() + 1);
+            registry.push_back(created);
+            return created;
+        }();
+        return *buffer;
+    }
+
+    int64_t now() {
+        return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - trace_epoch).count();
+    }
+
+    void writeMicroseconds(ostream& out, int64_t nanoseconds) {
+        out << nanoseconds / 1000 << '.';
+        int64_t fraction = nanoseconds % 1000;
+        if (fraction < 100) out << '0';
+        if (fraction < 10) out << '0';
+        out << fraction;
+    }
+}
+
+TraceSpan::TraceSpan(const char* span_name, const char* span_category):
+    name(span_name), category(span_category), start(tracing.load(memory_order_relaxed) ? now() : -1) {}
+
+TraceSpan::~TraceSpan() {
+    if (start < 0) return;
+    int64_t finish = now();
+    ThreadBuffer& buffer = threadBuffer();
+    lock_guard<mutex> guard(buffer.lock);
+    buffer.events.push_back({name, category, start, finish - start});
+}
+
+void startTracing() {
+    tracing.store(true, memory_order_relaxed);
+}
+
+void stopTracing() {
+    tracing.store(false, memory_order_relaxed);
+}
+
+bool isTracing() {
+    return tracing.load(memory_order_relaxed);
+}
+
+void clearTrace() {
+    lock_guard<mutex> guard(registry_lock);
+    for (const shared_ptr<ThreadBuffer>& buffer : registry) {
+        lock_guard<mutex> buffer_guard(buffer->lock);
+        buffer->events.clear();
+    }
+}
+
+void writeTrace(ostream& out) {
+    lock_guard<mutex> guard(registry_lock);
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    for (const shared_ptr<ThreadBuffer>& buffer : registry) {
+        lock_guard<mutex> buffer_guard(buffer->lock);
+        for (const TraceEvent& event : buffer->events) {
+            if (!first) out << ',';
+            first = false;
+            out << "\n{\"name\":\"" << event.name << "\",\"cat\":\"" << event.category
+                << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->thread_id << ",\"ts\":";
+            writeMicroseconds(out, event.start);
+            out << ",\"dur\":";
+            writeMicroseconds(out, event.duration);
+            out << '}';
+        }
+    }
+    out << "\n]}\n";
+}
+
+bool writeTraceFile(const string& filename) {
+    ofstream file(filename);
+    if (!file.is_open()) return false;
+    writeTrace(file);
+    return static_cast<bool>(file);
+}
@@ -5,8 +5,19 @@ using namespace std;
 Weather::Weather() : temperature{0} {}
 
 void Weather::setTemperature(int new_temperature) {
-    if(new_temperature < -273) throw invalid_argument("INVALID_ARGUMENT(temperature)");
+    if(!trySetTemperature(new_temperature)) throw invalid_argument("INVALID_ARGUMENT(temperature)");
+}
+
+Expected<void> Weather::trySetTemperature(int new_temperature) {
+    if(new_temperature < -273) return unexpected(WeatherError::InvalidTemperature);
     temperature = new_temperature;
+    return {};
+}
+
+Expected<Weather> Weather::tryMake(int temperature) {
+    Weather result;
+    if (auto status = result.trySetTemperature(temperature); !status) return unexpected(status.error());
+    return result;
 }
 
 int Weather::getTemperature() const{
@@ -29,9 +29,23 @@ WeatherDay::WeatherDay(Date dt, double newprecipitation, PartsOfDay parts) {
     choicePhenomen();
 }
 
+Expected<WeatherDay> WeatherDay::tryMake(Date dt, double newprecipitation, PartsOfDay parts) {
+    WeatherDay result;
+    if (auto status = result.trySetPrecipitation(newprecipitation); !status) return unexpected(status.error());
+    result.date = dt;
+    result.parts_of_day = parts;
+    result.choicePhenomen();
+    return result;
+}
+
 void WeatherDay::setPrecipitation(double new_precipitation) {
-    if(new_precipitation < 0) throw invalid_argument("INVALID_ARGUMENT(precipitation)");
+    if(!trySetPrecipitation(new_precipitation)) throw invalid_argument("INVALID_ARGUMENT(precipitation)");
+}
+
+Expected<void> WeatherDay::trySetPrecipitation(double new_precipitation) {
+    if(new_precipitation < 0) return unexpected(WeatherError::InvalidPrecipitation);
     precipitation = new_precipitation;
+    return {};
 }
 
 void WeatherDay::setPhenomen(int index) {
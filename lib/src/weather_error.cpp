@@ -0,0 +1,18 @@
+#include "weather_error.hpp"
+
+const char* errorMessage(WeatherError error) {
+    switch (error) {
+        case WeatherError::InvalidDay: return "INVALID_ARGUMENT(day)";
+        case WeatherError::InvalidMonth: return "INVALID_ARGUMENT(month)";
+        case WeatherError::InvalidYear: return "INVALID_ARGUMENT(year)";
+        case WeatherError::InvalidTemperature: return "INVALID_ARGUMENT(temperature)";
+        case WeatherError::InvalidPrecipitation: return "INVALID_ARGUMENT(precipitation)";
+        case WeatherError::InvalidCapacity: return "INVALID CAPACITY\n";
+        case WeatherError::InvalidIndex: return "INVALID INDEX\n";
+        case WeatherError::EmptyData: return "DATA IS EMPTY\n";
+        case WeatherError::NotFound: return "NOT FOUND\n";
+        case WeatherError::ParseError: return "PARSE ERROR\n";
+        case WeatherError::NotRepresentable: return "NOT REPRESENTABLE\n";
+    }
+    return "UNKNOWN ERROR\n";
+}
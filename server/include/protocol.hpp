@@ -0,0 +1,133 @@
+/**
+ * @file protocol.hpp
+ * @brief Двоичный протокол запросов к серверу прогнозов через Unix-сокет.
+ *
+ * Запрос — структура фиксированного размера (36 байт), ответ — заголовок
+ * (12 байт) и count записей WireDay. Порядок байт — родной для машины:
+ * клиент и сервер работают на одном узле. Клиент может отправлять запросы
+ * подряд, не дожидаясь ответов (конвейер); ответы приходят в том же порядке
+ * и несут id запроса.
+ */
+
+#ifndef FORECAST_PROTOCOL_HPP
+#define FORECAST_PROTOCOL_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "weather_lib.hpp"
+
+namespace protocol {
+
+/**
+ * @brief Тип запроса.
+ */
+enum class Op : uint8_t {
+    ColdestDay = 1, ///< findColdestDay(first, second)
+    NextSunnyDay,   ///< findNextSunnyDay(first)
+    Month,          ///< giveAllDaysOfMonth(month)
+    Lookup          ///< operator[](index)
+};
+
+/**
+ * @brief Результат обработки запроса.
+ */
+enum class Status : uint8_t {
+    Ok = 0,     ///< Ответ содержит count дней
+    NotFound,   ///< Подходящих дней нет (std::runtime_error)
+    BadRequest  ///< Некорректные аргументы (std::invalid_argument, std::out_of_range, неизвестный op)
+};
+
+/**
+ * @brief Дата на проводе.
+ */
+struct WireDate {
+    uint32_t day;
+    uint32_t month;
+    int32_t year;
+};
+
+/**
+ * @brief Запрос фиксированного размера.
+ */
+struct Request {
+    uint32_t id;          ///< Идентификатор, возвращаемый в ответе
+    Op op;                ///< Тип запроса
+    uint8_t reserved[3];  ///< Выравнивание, заполняется нулями
+    WireDate first;       ///< from (ColdestDay) или today (NextSunnyDay)
+    WireDate second;      ///< to (ColdestDay)
+    uint32_t argument;    ///< Месяц (Month) или индекс (Lookup)
+};
+
+/**
+ * @brief Заголовок ответа; за ним следуют count структур WireDay.
+ */
+struct ResponseHeader {
+    uint32_t id;          ///< id запроса
+    Status status;        ///< Результат
+    uint8_t reserved[3];  ///< Выравнивание, заполняется нулями
+    uint32_t count;       ///< Количество дней в ответе
+};
+
+/**
+ * @brief Прогноз на один день на проводе.
+ */
+struct WireDay {
+    WireDate date;
+    int32_t morning;      ///< Температура утром
+    int32_t day;          ///< Температура днём
+    int32_t evening;      ///< Температура вечером
+    uint32_t phenomen;    ///< Значение Phenomen
+    double precipitation; ///< Осадки
+};
+
+static_assert(sizeof(Request) == 36);
+static_assert(sizeof(ResponseHeader) == 12);
+static_assert(sizeof(WireDay) == 40);
+
+inline WireDate toWire(const Date& date) {
+    return {date.getDay(), date.getMonth(), date.getYear()};
+}
+
+inline Date fromWire(const WireDate& date) {
+    return Date(date.day, date.month, date.year);
+}
+
+inline WireDay toWire(const WeatherDay& day) {
+    PartsOfDay parts = day.getPartsOfDay();
+    return {toWire(day.getDate()),
+            parts.getMorning().getTemperature(), parts.getDay().getTemperature(), parts.getEvening().getTemperature(),
+            static_cast<uint32_t>(day.getPhenomen()), day.getPrecipitation()};
+}
+
+/**
+ * @brief Дописывает значение тривиального типа в буфер.
+ */
+template <typename T>
+void put(std::vector<char>& buffer, const T& value) {
+    const char* bytes = reinterpret_cast<const char*>(&value);
+    buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+}
+
+/**
+ * @brief Читает значение тривиального типа из буфера без требований к выравниванию.
+ */
+template <typename T>
+T get(const char* bytes) {
+    T value;
+    std::memcpy(&value, bytes, sizeof(T));
+    return value;
+}
+
+/**
+ * @brief Размер полного ответа по его заголовку.
+ */
+inline size_t responseSize(const ResponseHeader& header) {
+    return sizeof(ResponseHeader) + header.count * sizeof(WireDay);
+}
+
+} // namespace protocol
+
+#endif // FORECAST_PROTOCOL_HPP
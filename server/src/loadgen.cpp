@@ -0,0 +1,180 @@
+// Генератор нагрузки для forecast_server: измеряет QPS и задержки p50/p99.
+// Использование: forecast_loadgen <путь к сокету> [соединений=4] [запросов на соединение=100000] [глубина конвейера=16]
+
+#include <algorithm>
+#include <chrono>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "protocol.hpp"
+
+using namespace std;
+using namespace protocol;
+using Clock = chrono::steady_clock;
+
+namespace {
+
+struct ClientStats {
+    vector<uint64_t> latencies; ///< Задержки ответов, нс
+    size_t errors = 0;          ///< Ответы со статусом, отличным от Ok и NotFound
+};
+
+int connectTo(const string& path) {
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path)) throw invalid_argument("SOCKET PATH TOO LONG\n");
+    strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+    int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd == -1 || ::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        throw runtime_error(string("connect: ") + strerror(errno));
+    }
+    return fd;
+}
+
+void sendAll(int fd, const vector<char>& buffer) {
+    size_t sent = 0;
+    while (sent < buffer.size()) {
+        ssize_t written = ::send(fd, buffer.data() + sent, buffer.size() - sent, MSG_NOSIGNAL);
+        if (written == -1) {
+            if (errno == EINTR) continue;
+            throw runtime_error(string("send: ") + strerror(errno));
+        }
+        sent += written;
+    }
+}
+
+// Смесь запросов: в основном точечные и по диапазону, реже — целый месяц
+Request makeRequest(uint32_t id, mt19937& rng) {
+    Request request{};
+    request.id = id;
+    uint32_t kind = rng() % 16;
+    int year = 2000 + static_cast<int>(rng() % 30);
+    uint32_t day = 1 + rng() % 28;
+    uint32_t month = 1 + rng() % 12;
+    if (kind < 6) {
+        request.op = Op::Lookup;
+        request.argument = rng() % 1024;
+    } else if (kind < 11) {
+        request.op = Op::ColdestDay;
+        request.first = {day, month, year};
+        request.second = {day, month, year + 1};
+    } else if (kind < 15) {
+        request.op = Op::NextSunnyDay;
+        request.first = {day, month, year};
+    } else {
+        request.op = Op::Month;
+        request.argument = month;
+    }
+    return request;
+}
+
+// Одно соединение: держит до depth запросов в полёте
+void runClient(const string& path, size_t requests, size_t depth, unsigned seed, ClientStats& stats) {
+    int fd = connectTo(path);
+    mt19937 rng(seed);
+    vector<Clock::time_point> started(requests);
+    stats.latencies.reserve(requests);
+    vector<char> out;
+    vector<char> in;
+    size_t issued = 0;
+    size_t completed = 0;
+    while (completed < requests) {
+        out.clear();
+        while (issued < requests && issued - completed < depth) {
+            started[issued] = Clock::now();
+            put(out, makeRequest(static_cast<uint32_t>(issued), rng));
+            issued++;
+        }
+        if (!out.empty()) sendAll(fd, out);
+
+        char chunk[64 * 1024];
+        ssize_t received = ::recv(fd, chunk, sizeof(chunk), 0);
+        if (received == -1 && errno == EINTR) continue;
+        if (received <= 0) throw runtime_error("connection closed by server");
+        in.insert(in.end(), chunk, chunk + received);
+        Clock::time_point now = Clock::now();
+
+        size_t offset = 0;
+        while (offset + sizeof(ResponseHeader) <= in.size()) {
+            ResponseHeader header = protocol::get<ResponseHeader>(in.data() + offset);
+            size_t size = responseSize(header);
+            if (offset + size > in.size()) break;
+            if (header.id >= issued || header.id >= started.size()) throw runtime_error("reply with unknown request id");
+            stats.latencies.push_back(chrono::duration_cast<chrono::nanoseconds>(now - started[header.id]).count());
+            if (header.status == Status::BadRequest) stats.errors++;
+            offset += size;
+            completed++;
+        }
+        in.erase(in.begin(), in.begin() + offset);
+    }
+    ::close(fd);
+}
+
+double percentile(const vector<uint64_t>& sorted, double fraction) {
+    if (sorted.empty()) return 0;
+    size_t index = min(sorted.size() - 1, static_cast<size_t>(fraction * sorted.size()));
+    return sorted[index] / 1000.0;
+}
+
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2 || argc > 5) {
+        cerr << "Usage: " << argv[0] << " <socket path> [connections] [requests per connection] [pipeline depth]\n";
+        return 2;
+    }
+    string path = argv[1];
+    size_t connections = argc > 2 ? stoul(argv[2]) : 4;
+    size_t requests = argc > 3 ? stoul(argv[3]) : 100000;
+    size_t depth = argc > 4 ? stoul(argv[4]) : 16;
+    if (connections == 0 || requests == 0 || depth == 0) {
+        cerr << "All counts must be positive\n";
+        return 2;
+    }
+
+    vector<ClientStats> stats(connections);
+    vector<thread> clients;
+    vector<string> failures(connections);
+    Clock::time_point begin = Clock::now();
+    for (size_t i = 0; i < connections; i++) {
+        clients.emplace_back([&, i]() {
+            try {
+                runClient(path, requests, depth, static_cast<unsigned>(i + 1), stats[i]);
+            } catch (const exception& error) {
+                failures[i] = error.what();
+            }
+        });
+    }
+    for (thread& client : clients) client.join();
+    double seconds = chrono::duration<double>(Clock::now() - begin).count();
+
+    for (const string& failure : failures) {
+        if (!failure.empty()) {
+            cerr << failure << "\n";
+            return 1;
+        }
+    }
+    vector<uint64_t> latencies;
+    size_t errors = 0;
+    for (const ClientStats& client : stats) {
+        latencies.insert(latencies.end(), client.latencies.begin(), client.latencies.end());
+        errors += client.errors;
+    }
+    sort(latencies.begin(), latencies.end());
+    cout << "requests:    " << latencies.size() << " (" << errors << " bad requests)\n"
+         << "qps:         " << static_cast<uint64_t>(latencies.size() / seconds) << "\n"
+         << "p50 latency: " << percentile(latencies, 0.50) << " us\n"
+         << "p99 latency: " << percentile(latencies, 0.99) << " us\n"
+         << "max latency: " << (latencies.empty() ? 0 : latencies.back() / 1000.0) << " us\n";
+    return 0;
+}
@@ -0,0 +1,270 @@
+// Сервер запросов к прогнозу через Unix-сокет.
+// Использование: forecast_server <путь к сокету> <файл с прогнозами>
+
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <sys/epoll.h>
+#include <sys/signalfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "protocol.hpp"
+#include "weather_lib.hpp"
+
+using namespace std;
+using namespace protocol;
+
+namespace {
+
+constexpr size_t READ_CHUNK = 64 * 1024;
+constexpr int MAX_EVENTS = 64;
+// Предел неотправленных ответов: выше него соединение перестаёт читаться и
+// разбирать запросы, пока клиент не заберёт ответы. Буфер out превышает его
+// не больше чем на один ответ, а in — не больше чем на READ_CHUNK
+constexpr size_t OUTPUT_HIGH_WATER = 4 * 1024 * 1024;
+
+struct Connection {
+    vector<char> in;    ///< Принятые, но ещё не разобранные байты
+    vector<char> out;   ///< Ответы, ещё не отправленные клиенту
+    size_t sent = 0;    ///< Сколько байт out уже отправлено
+    uint32_t events = EPOLLIN | EPOLLRDHUP; ///< Текущая подписка epoll
+    bool closing = false; ///< Клиент закрыл свою сторону: дописываем ответы и закрываем
+};
+
+size_t unsent(const Connection& connection) {
+    return connection.out.size() - connection.sent;
+}
+
+void check(bool ok, const char* what) {
+    if (!ok) throw runtime_error(string(what) + ": " + strerror(errno));
+}
+
+// Выполняет запрос и дописывает ответ в буфер
+void answer(const Forecast& forecast, const Request& request, vector<char>& out) {
+    ResponseHeader header{request.id, Status::Ok, {0, 0, 0}, 0};
+    vector<WireDay> days;
+    try {
+        switch (request.op) {
+            case Op::ColdestDay:
+                days.push_back(toWire(forecast.findColdestDay(fromWire(request.first), fromWire(request.second))));
+                break;
+            case Op::NextSunnyDay:
+                days.push_back(toWire(forecast.findNextSunnyDay(fromWire(request.first))));
+                break;
+            case Op::Month: {
+                Forecast month = forecast.giveAllDaysOfMonth(request.argument);
+                for (size_t i = 0; i < month.getCount(); i++) days.push_back(toWire(month[i]));
+                break;
+            }
+            case Op::Lookup:
+                days.push_back(toWire(forecast[request.argument]));
+                break;
+            default:
+                header.status = Status::BadRequest;
+        }
+    } catch (const invalid_argument&) {
+        header.status = Status::BadRequest;
+    } catch (const out_of_range&) {
+        header.status = Status::BadRequest;
+    } catch (const runtime_error&) {
+        header.status = Status::NotFound;
+    }
+    if (header.status != Status::Ok) days.clear();
+    header.count = static_cast<uint32_t>(days.size());
+    put(out, header);
+    for (const WireDay& day : days) put(out, day);
+}
+
+class Server {
+private:
+    const Forecast& forecast;
+    int listener;
+    int signals;
+    int epoll;
+    unordered_map<int, Connection> connections;
+
+    void watch(int fd, uint32_t events, int operation) {
+        epoll_event event{};
+        event.events = events;
+        event.data.fd = fd;
+        check(epoll_ctl(epoll, operation, fd, &event) == 0, "epoll_ctl");
+    }
+
+    void close(int fd) {
+        epoll_ctl(epoll, EPOLL_CTL_DEL, fd, nullptr);
+        ::close(fd);
+        connections.erase(fd);
+    }
+
+    void accept() {
+        while (true) {
+            int fd = ::accept4(listener, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd == -1) {
+                if (errno == EAGAIN || errno == EWOULDBLOCK) return;
+                check(errno == EINTR || errno == ECONNABORTED, "accept");
+                continue;
+            }
+            connections.emplace(fd, Connection());
+            watch(fd, EPOLLIN | EPOLLRDHUP, EPOLL_CTL_ADD);
+        }
+    }
+
+    // Отправляет накопленные ответы и отвечает на отложенные запросы по мере
+    // освобождения out; false — соединение закрыто
+    bool flush(int fd, Connection& connection) {
+        do {
+            while (connection.sent < connection.out.size()) {
+                ssize_t written = ::send(fd, connection.out.data() + connection.sent,
+                                         connection.out.size() - connection.sent, MSG_NOSIGNAL);
+                if (written == -1) {
+                    if (errno == EINTR) continue;
+                    if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+                    return false;
+                }
+                connection.sent += written;
+            }
+            if (connection.sent == connection.out.size()) {
+                connection.out.clear();
+                connection.sent = 0;
+            }
+        } while (answerAll(connection));
+        bool pending = !connection.out.empty();
+        if (connection.closing && !pending) return false;
+        // После закрытия стороны клиента или при переполнении out чтение не отслеживается
+        bool throttled = connection.closing || unsent(connection) > OUTPUT_HIGH_WATER;
+        uint32_t reading = throttled ? 0u : static_cast<uint32_t>(EPOLLIN | EPOLLRDHUP);
+        uint32_t events = reading | (pending ? static_cast<uint32_t>(EPOLLOUT) : 0u);
+        if (events != connection.events) {
+            connection.events = events;
+            watch(fd, events, EPOLL_CTL_MOD);
+        }
+        return true;
+    }
+
+    // Отвечает на полные запросы из in, пока неотправленных ответов не больше
+    // OUTPUT_HIGH_WATER; остальные ждут отправки. false — ни одного ответа
+    bool answerAll(Connection& connection) {
+        size_t offset = 0;
+        for (; offset + sizeof(Request) <= connection.in.size() && unsent(connection) <= OUTPUT_HIGH_WATER;
+             offset += sizeof(Request)) {
+            answer(forecast, protocol::get<Request>(connection.in.data() + offset), connection.out);
+        }
+        connection.in.erase(connection.in.begin(), connection.in.begin() + offset);
+        return offset != 0;
+    }
+
+    // Читает доступные данные и отвечает на полные запросы; false — соединение закрыто.
+    // Чтение прекращается, когда out переполнен: клиент, не забирающий ответы, тормозится.
+    // Если клиент закрыл свою сторону, уже готовые ответы сначала дописываются
+    bool receive(int fd, Connection& connection) {
+        while (unsent(connection) <= OUTPUT_HIGH_WATER) {
+            size_t old_size = connection.in.size();
+            connection.in.resize(old_size + READ_CHUNK);
+            ssize_t received = ::recv(fd, connection.in.data() + old_size, READ_CHUNK, 0);
+            connection.in.resize(old_size + max<ssize_t>(received, 0));
+            if (received > 0) {
+                answerAll(connection);
+                continue;
+            }
+            if (received == -1 && errno == EINTR) continue;
+            if (received == 0) connection.closing = true;
+            else if (errno != EAGAIN && errno != EWOULDBLOCK) return false;
+            break;
+        }
+        return flush(fd, connection);
+    }
+
+public:
+    Server(const Forecast& loaded, const string& path): forecast(loaded) {
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        if (path.size() >= sizeof(address.sun_path)) throw invalid_argument("SOCKET PATH TOO LONG\n");
+        strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+        ::unlink(path.c_str());
+        listener = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        check(listener != -1, "socket");
+        check(::bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0, "bind");
+        check(::listen(listener, SOMAXCONN) == 0, "listen");
+
+        sigset_t mask;
+        sigemptyset(&mask);
+        sigaddset(&mask, SIGINT);
+        sigaddset(&mask, SIGTERM);
+        check(sigprocmask(SIG_BLOCK, &mask, nullptr) == 0, "sigprocmask");
+        signals = ::signalfd(-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC);
+        check(signals != -1, "signalfd");
+
+        epoll = ::epoll_create1(EPOLL_CLOEXEC);
+        check(epoll != -1, "epoll_create1");
+        watch(listener, EPOLLIN, EPOLL_CTL_ADD);
+        watch(signals, EPOLLIN, EPOLL_CTL_ADD);
+    }
+
+    ~Server() {
+        for (auto& [fd, connection] : connections) ::close(fd);
+        ::close(epoll);
+        ::close(signals);
+        ::close(listener);
+    }
+
+    // Цикл событий; завершается по SIGINT или SIGTERM
+    void run() {
+        epoll_event events[MAX_EVENTS];
+        while (true) {
+            int ready = ::epoll_wait(epoll, events, MAX_EVENTS, -1);
+            if (ready == -1) {
+                check(errno == EINTR, "epoll_wait");
+                continue;
+            }
+            for (int i = 0; i < ready; i++) {
+                int fd = events[i].data.fd;
+                if (fd == signals) return;
+                if (fd == listener) {
+                    accept();
+                    continue;
+                }
+                auto found = connections.find(fd);
+                if (found == connections.end()) continue;
+                Connection& connection = found->second;
+                bool open = !(events[i].events & EPOLLERR);
+                if (open && (events[i].events & EPOLLOUT)) open = flush(fd, connection);
+                if (open && (events[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP))) {
+                    open = connection.closing ? flush(fd, connection) : receive(fd, connection);
+                }
+                if (!open) close(fd);
+            }
+        }
+    }
+};
+
+}
+
+int main(int argc, char** argv) {
+    if (argc != 3) {
+        cerr << "Usage: " << argv[0] << " <socket path> <forecast file>\n";
+        return 2;
+    }
+    try {
+        Forecast forecast;
+        if (!importForecastFromFile(argv[2], forecast)) {
+            cerr << "Cannot read " << argv[2] << "\n";
+            return 1;
+        }
+        Server server(forecast, argv[1]);
+        cerr << "Serving " << forecast.getCount() << " days on " << argv[1] << "\n";
+        server.run();
+        ::unlink(argv[1]);
+    } catch (const exception& error) {
+        cerr << error.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -1,12 +1,40 @@
 #include <gtest/gtest.h>
+#include <algorithm>
 #include <cmath>
+#include <cstring>
 #include <vector>
+#include <thread>
+#include <atomic>
+#include <memory_resource>
+#include <sstream>
+#include <stop_token>
+#include <string>
+
+#ifdef __unix__
+#include <unistd.h>
+#endif
 
 #include "date.hpp"
 #include "weather.hpp"
 #include "parts_of_day.hpp"
 #include "weather_day.hpp"
 #include "forecast.hpp"
+#include "segmented_forecast.hpp"
+#include "packed_forecast.hpp"
+#include "rolling_forecast.hpp"
+#include "concurrent_forecast.hpp"
+#include "spsc_queue.hpp"
+#include "forecast_store.hpp"
+#include "thread_pool.hpp"
+#include "batch_query.hpp"
+#include "forecast_io.hpp"
+#include "forecast_archive.hpp"
+#include "async_forecast.hpp"
+#include "shared_forecast.hpp"
+#include "forecast_generator.hpp"
+#include "forecast_metrics.hpp"
+#include "trace.hpp"
+#include "logging.hpp"
 
 
 void forecast_days_setup(Forecast& f) {
@@ -235,6 +263,1152 @@ TEST_F(ForecastTest, GiveAllDaysOfMonth) {
     EXPECT_EQ(jan[0].getDate().getMonth(), 1);
 }
 
+TEST_F(ForecastTest, SortMergesAscendingRuns) {
+    Weather w; w.setTemperature(10);
+    PartsOfDay p; p.setMorning(w); p.setDay(w); p.setEvening(w);
+    f += WeatherDay(Date(3,1,2023), 0.0, p, static_cast<int>(Phenomen::Sunny));
+    f += WeatherDay(Date(5,2,2023), 0.0, p, static_cast<int>(Phenomen::Sunny));
+    f += WeatherDay(Date(1,1,2024), 0.0, p, static_cast<int>(Phenomen::Sunny));
+    EXPECT_TRUE(f.isSorted());
+    f += WeatherDay(Date(1,1,2023), 0.0, p, static_cast<int>(Phenomen::Sunny));
+    f += WeatherDay(Date(4,2,2023), 0.0, p, static_cast<int>(Phenomen::Sunny));
+    f += WeatherDay(Date(2,1,2023), 0.0, p, static_cast<int>(Phenomen::Sunny));
+    EXPECT_FALSE(f.isSorted());
+
+    f.sortDaysByData();
+    EXPECT_TRUE(f.isSorted());
+    const Forecast& view = f;
+    for (size_t i = 1; i < 6; i++) {
+        EXPECT_FALSE(view[i].getDate() < view[i - 1].getDate());
+    }
+    EXPECT_EQ(view[0].getDate(), Date(1,1,2023));
+    EXPECT_EQ(view[5].getDate(), Date(1,1,2024));
+}
+
+TEST_F(ForecastTest, SortedFlagTracking) {
+    forecast_days_setup(f);
+    EXPECT_TRUE(f.isSorted());
+    f.deleteByIndex(1);
+    EXPECT_TRUE(f.isSorted());
+    f[0];
+    EXPECT_FALSE(f.isSorted());
+    f.sortDaysByData();
+    EXPECT_TRUE(f.isSorted());
+    Forecast copy(f);
+    EXPECT_TRUE(copy.isSorted());
+}
+
+TEST_F(ForecastTest, MergeSortedCombinesProviders) {
+    Weather w10; w10.setTemperature(10);
+    PartsOfDay p10; p10.setMorning(w10); p10.setDay(w10); p10.setEvening(w10);
+    Weather w20; w20.setTemperature(20);
+    PartsOfDay p20; p20.setMorning(w20); p20.setDay(w20); p20.setEvening(w20);
+    f += WeatherDay(Date(1,1,2023), 0.0, p10, static_cast<int>(Phenomen::Cloudy));
+    f += WeatherDay(Date(3,1,2023), 0.0, p10, static_cast<int>(Phenomen::Cloudy));
+    Forecast other;
+    other += WeatherDay(Date(2,1,2023), 0.0, p20, static_cast<int>(Phenomen::Cloudy));
+    other += WeatherDay(Date(3,1,2023), 0.0, p20, static_cast<int>(Phenomen::Rainy));
+    other += WeatherDay(Date(4,1,2023), 0.0, p20, static_cast<int>(Phenomen::Cloudy));
+
+    Forecast merged = f | other;
+    ASSERT_EQ(merged.getCount(), 4);
+    EXPECT_TRUE(merged.isSorted());
+    const Forecast& view = merged;
+    EXPECT_EQ(view[0].getDate(), Date(1,1,2023));
+    EXPECT_EQ(view[1].getDate(), Date(2,1,2023));
+    EXPECT_EQ(view[2].getDate(), Date(3,1,2023));
+    EXPECT_EQ(view[2].averageTempOfDay(), 15);
+    EXPECT_EQ(view[2].getPhenomen(), Phenomen::Rainy);
+    EXPECT_EQ(view[3].getDate(), Date(4,1,2023));
+
+    Forecast preferred = f.mergeSorted(other, [](WeatherDay&, const WeatherDay&) {});
+    EXPECT_EQ(static_cast<const Forecast&>(preferred)[2].averageTempOfDay(), 10);
+}
+
+TEST_F(ForecastTest, MergeSortedRejectsUnsorted) {
+    forecast_days_setup(f);
+    Forecast unsorted;
+    unsorted += createStandardDay(10, 10, 10, 0, Phenomen::Sunny);
+    unsorted += WeatherDay(Date(1,1,1999), 0.0, PartsOfDay(), static_cast<int>(Phenomen::Cloudy));
+    EXPECT_THROW(f.mergeSorted(unsorted), std::invalid_argument);
+    Forecast empty;
+    EXPECT_EQ((f | empty).getCount(), 3);
+}
+
+TEST_F(ForecastTest, LazyDeletionKeepsIndicesConsistent) {
+    f.setLazyDeletion(true);
+    f.setCompactionThreshold(1.0);
+    for (int i = 0; i < 10; ++i) {
+        f += WeatherDay(Date(1 + i, 1, 2023), 0.0, PartsOfDay(), static_cast<int>(Phenomen::Cloudy));
+    }
+    f.deleteByIndex(0);
+    f.deleteByIndex(4);
+    f.deleteByIndex(7);
+    ASSERT_EQ(f.getCount(), 7);
+    const Forecast& view = f;
+    const uint32_t expected[] = {2, 3, 4, 5, 7, 8, 9};
+    for (size_t i = 0; i < 7; i++) {
+        EXPECT_EQ(view[i].getDate().getDay(), expected[i]);
+    }
+    EXPECT_THROW(view[7], std::out_of_range);
+    EXPECT_THROW(f.deleteByIndex(7), std::invalid_argument);
+
+    f += WeatherDay(Date(20, 1, 2023), 0.0, PartsOfDay(), static_cast<int>(Phenomen::Cloudy));
+    EXPECT_EQ(view[7].getDate().getDay(), 20);
+    EXPECT_EQ(f.giveAllDaysOfMonth(1).getCount(), 8);
+
+    f.compact();
+    EXPECT_EQ(f.getCount(), 8);
+    EXPECT_EQ(view[4].getDate().getDay(), 7);
+}
+
+TEST_F(ForecastTest, LazyDeletionQueriesSkipTombstones) {
+    forecast_days_setup(f);
+    f.setLazyDeletion(true);
+    f.deleteByIndex(1);
+    WeatherDay coldest = f.findColdestDay(Date(1, 1, 2022), Date(1, 1, 2024));
+    EXPECT_EQ(coldest.averageTempOfDay(), -10);
+
+    f.setCompactionThreshold(0.5);
+    f.deleteByIndex(0);
+    EXPECT_EQ(f.getCount(), 1);
+    EXPECT_EQ(static_cast<const Forecast&>(f)[0].averageTempOfDay(), 5);
+}
+
+TEST_F(ForecastTest, CopyOnWriteSharesUntilMutation) {
+    forecast_days_setup(f);
+    Forecast snapshot(f);
+    Forecast assigned;
+    assigned = f;
+    const Forecast& original = f;
+    const Forecast& shared = snapshot;
+    EXPECT_EQ(&original[0], &shared[0]);
+    EXPECT_EQ(&original[0], &static_cast<const Forecast&>(assigned)[0]);
+
+    f.deleteByIndex(0);
+    EXPECT_NE(&original[0], &shared[0]);
+    EXPECT_EQ(snapshot.getCount(), 3);
+    EXPECT_EQ(shared[0].averageTempOfDay(), -10);
+    EXPECT_EQ(original[0].averageTempOfDay(), -20);
+
+    snapshot += createStandardDay(1, 1, 1, 0, Phenomen::Cloudy);
+    EXPECT_EQ(assigned.getCount(), 3);
+    EXPECT_EQ(snapshot.getCount(), 4);
+}
+
+TEST(SegmentedForecastTest, AppendNeverMovesExistingDays) {
+    SegmentedForecast s(4);
+    EXPECT_THROW(SegmentedForecast(3), std::invalid_argument);
+    for (int i = 0; i < 10; ++i) {
+        Weather w; w.setTemperature(i);
+        PartsOfDay p; p.setMorning(w); p.setDay(w); p.setEvening(w);
+        s += WeatherDay(Date(1 + i, 3, 2023), 0.0, p, static_cast<int>(Phenomen::Cloudy));
+    }
+    const WeatherDay* first = &s[0];
+    s += WeatherDay(Date(20, 3, 2023), 0.0, PartsOfDay(), static_cast<int>(Phenomen::Sunny));
+    EXPECT_EQ(first, &s[0]);
+    EXPECT_EQ(s.getCount(), 11);
+    EXPECT_EQ(s.getChunkCount(), 3);
+    EXPECT_EQ(s.segments().back().size(), 3);
+    EXPECT_EQ(s[9].averageTempOfDay(), 9);
+    EXPECT_THROW(s[11], std::out_of_range);
+}
+
+TEST(SegmentedForecastTest, QueriesScanAcrossChunks) {
+    Forecast f;
+    forecast_days_setup(f);
+    SegmentedForecast s(f, 2);
+    EXPECT_EQ(s.findColdestDay(Date(1,1,2022), Date(1,1,2024)).averageTempOfDay(), -20);
+    EXPECT_EQ(s.findNextSunnyDay(Date(1,1,2023)).getDate(), Date(2,1,2023));
+    EXPECT_EQ(s.giveAllDaysOfMonth(1).getCount(), 3);
+    EXPECT_THROW(s.giveAllDaysOfMonth(2), std::runtime_error);
+
+    s += WeatherDay(Date(4,1,2023), 5000.0, PartsOfDay(), static_cast<int>(Phenomen::Rainy));
+    s.deleteAllErrors();
+    EXPECT_EQ(s.getCount(), 3);
+    EXPECT_EQ(s.getChunkCount(), 2);
+    EXPECT_EQ(s.toForecast().getCount(), 3);
+}
+
+TEST(ConcurrentForecastTest, SnapshotIsStableDuringWrites) {
+    Forecast f;
+    forecast_days_setup(f);
+    ConcurrentForecast cf(f);
+    auto before = cf.snapshot();
+    cf += WeatherDay(Date(4,1,2023), 0.0, PartsOfDay(), static_cast<int>(Phenomen::Cloudy));
+    cf.deleteByIndex(1);
+    auto after = cf.snapshot();
+
+    EXPECT_EQ(before.getCount(), 3);
+    EXPECT_EQ(before.findColdestDay(Date(1,1,2022), Date(1,1,2024)).averageTempOfDay(), -20);
+    EXPECT_EQ(after.getCount(), 3);
+    EXPECT_EQ(after.findColdestDay(Date(1,1,2022), Date(1,1,2024)).averageTempOfDay(), -10);
+    EXPECT_GT(after.getVersion(), before.getVersion());
+    EXPECT_GT(cf.getRetiredCount(), 0);
+
+    { auto released = std::move(before); }
+    { auto released = std::move(after); }
+    EXPECT_EQ(cf.getRetiredCount(), 0);
+}
+
+TEST(ConcurrentForecastTest, ReadersDuringIngest) {
+    ConcurrentForecast cf;
+    std::atomic<bool> done{false};
+    std::thread writer([&cf, &done]() {
+        for (int i = 0; i < 2000; ++i) {
+            Weather w; w.setTemperature(i % 50);
+            PartsOfDay p; p.setMorning(w); p.setDay(w); p.setEvening(w);
+            cf += WeatherDay(Date(1 + i % 28, 1 + i % 12, 2000 + i / 336), 0.0, p, static_cast<int>(Phenomen::Cloudy));
+        }
+        done = true;
+    });
+    std::vector<std::thread> readers;
+    std::atomic<bool> consistent{true};
+    for (int r = 0; r < 3; ++r) {
+        readers.emplace_back([&cf, &done, &consistent]() {
+            size_t last_count = 0;
+            while (!done) {
+                auto snap = cf.snapshot();
+                if (snap.getCount() < last_count) consistent = false;
+                for (size_t i = 0; i < snap.getCount(); i++) {
+                    if (snap[i].averageTempOfDay() != static_cast<int>(i % 50)) consistent = false;
+                }
+                last_count = snap.getCount();
+            }
+        });
+    }
+    writer.join();
+    for (auto& reader : readers) reader.join();
+    EXPECT_TRUE(consistent);
+    EXPECT_EQ(cf.snapshot().getCount(), 2000);
+}
+
+TEST_F(ForecastTest, AppendBatch) {
+    forecast_days_setup(f);
+    std::vector<WeatherDay> batch;
+    for (int i = 0; i < 5; ++i) {
+        batch.push_back(WeatherDay(Date(10 + i, 1, 2023), 0.0, PartsOfDay(), static_cast<int>(Phenomen::Cloudy)));
+    }
+    f.append(batch);
+    EXPECT_EQ(f.getCount(), 8);
+    EXPECT_TRUE(f.isSorted());
+    EXPECT_EQ(static_cast<const Forecast&>(f)[7].getDate(), Date(14, 1, 2023));
+    f.append(std::vector<WeatherDay>{WeatherDay(Date(1, 1, 2020), 0.0, PartsOfDay(), 2)});
+    EXPECT_FALSE(f.isSorted());
+}
+
+TEST(SpscQueueTest, BoundedFifo) {
+    EXPECT_THROW(SpscQueue<int>(3), std::invalid_argument);
+    SpscQueue<int> queue(2);
+    int value = 1;
+    EXPECT_TRUE(queue.tryPush(std::move(value)));
+    value = 2;
+    EXPECT_TRUE(queue.tryPush(std::move(value)));
+    value = 3;
+    EXPECT_FALSE(queue.tryPush(std::move(value)));
+    int out = 0;
+    EXPECT_TRUE(queue.tryPop(out));
+    EXPECT_EQ(out, 1);
+    EXPECT_TRUE(queue.tryPush(std::move(value)));
+    std::vector<int> drained;
+    EXPECT_EQ(queue.drain([&drained](int& item) { drained.push_back(item); }), 2);
+    EXPECT_EQ(drained, (std::vector<int>{2, 3}));
+    EXPECT_FALSE(queue.tryPop(out));
+}
+
+TEST(SpscQueueTest, DrainBatchesIntoForecast) {
+    SpscQueue<std::vector<WeatherDay>> queue(8);
+    const size_t batches = 500;
+    const size_t batch_size = 16;
+    std::thread producer([&queue]() {
+        for (size_t b = 0; b < batches; ++b) {
+            std::vector<WeatherDay> batch;
+            for (size_t i = 0; i < batch_size; ++i) {
+                Weather w; w.setTemperature(static_cast<int>((b * batch_size + i) % 40));
+                PartsOfDay p; p.setMorning(w); p.setDay(w); p.setEvening(w);
+                batch.push_back(WeatherDay(Date(1, 1, 2000), 0.0, p, static_cast<int>(Phenomen::Cloudy)));
+            }
+            while (!queue.tryPush(std::move(batch))) std::this_thread::yield();
+        }
+    });
+    Forecast f;
+    while (f.getCount() < batches * batch_size) {
+        queue.drain([&f](std::vector<WeatherDay>& batch) { f.append(batch); });
+    }
+    producer.join();
+    const Forecast& view = f;
+    for (size_t i = 0; i < f.getCount(); ++i) {
+        ASSERT_EQ(view[i].averageTempOfDay(), static_cast<int>(i % 40));
+    }
+}
+
+TEST_F(ForecastTest, FindColdestDayEmptyRange) {
+    forecast_days_setup(f);
+    EXPECT_THROW(f.findColdestDay(Date(1,1,2030), Date(1,1,2031)), std::runtime_error);
+}
+
+TEST_F(ForecastTest, FindColdestDaysMatchesSingleQueries) {
+    Forecast f;
+    EXPECT_THROW(f.findColdestDays(std::vector<DateRange>{}), std::invalid_argument);
+    for (int i = 0; i < 60; ++i) {
+        Weather w; w.setTemperature((i * 37) % 23 - 11);
+        PartsOfDay p; p.setMorning(w); p.setDay(w); p.setEvening(w);
+        f += WeatherDay(Date(1 + (i * 11) % 28, 1 + i % 3, 2024), 0.0, p);
+    }
+    f.setLazyDeletion(true);
+    f.deleteByIndex(5);
+    f.deleteByIndex(17);
+
+    std::vector<DateRange> ranges;
+    for (int m = 1; m <= 3; ++m) {
+        for (int d = 1; d <= 28; d += 3) {
+            ranges.push_back({Date(d, m, 2024), Date(1 + (d * 5) % 28, m + d % 3, 2024)});
+        }
+    }
+    ranges.push_back({Date(1, 1, 2030), Date(1, 1, 2031)});
+
+    for (int pass = 0; pass < 2; ++pass) {
+        auto results = f.findColdestDays(ranges);
+        ASSERT_EQ(results.size(), ranges.size());
+        EXPECT_GT(std::count_if(results.begin(), results.end(), [](const auto& r) { return r.has_value(); }), 10);
+        EXPECT_FALSE(results.back().has_value());
+        for (size_t q = 0; q < ranges.size(); ++q) {
+            if (!(ranges[q].from < ranges[q].to) || !results[q]) {
+                EXPECT_THROW(f.findColdestDay(ranges[q].from, ranges[q].to), std::runtime_error);
+                continue;
+            }
+            WeatherDay expected = f.findColdestDay(ranges[q].from, ranges[q].to);
+            EXPECT_EQ(results[q]->getDate(), expected.getDate());
+            EXPECT_EQ(results[q]->averageTempOfDay(), expected.averageTempOfDay());
+        }
+        f.compact();
+        f.sortDaysByData();
+    }
+}
+
+TEST_F(ForecastTest, QueryCacheInvalidatedByMutations) {
+    Forecast f;
+    for (int day = 1; day <= 10; ++day) {
+        Weather w; w.setTemperature(day);
+        PartsOfDay p; p.setMorning(w); p.setDay(w); p.setEvening(w);
+        int phenomen = day % 4 == 0 ? static_cast<int>(Phenomen::Sunny) : static_cast<int>(Phenomen::Cloudy);
+        f += WeatherDay(Date(day, 1 + day % 2, 2024), 0.0, p, phenomen);
+    }
+    EXPECT_FALSE(f.isQueryCacheEnabled());
+    f.findColdestDay(Date(1, 1, 2024), Date(1, 3, 2024));
+    EXPECT_EQ(f.getCacheMisses(), 0);
+
+    f.setQueryCache(true);
+    EXPECT_EQ(f.findColdestDay(Date(1, 1, 2024), Date(1, 3, 2024)).averageTempOfDay(), 1);
+    EXPECT_EQ(f.findColdestDay(Date(1, 1, 2024), Date(1, 3, 2024)).averageTempOfDay(), 1);
+    EXPECT_EQ(f.giveAllDaysOfMonth(2).getCount(), 5);
+    EXPECT_EQ(f.giveAllDaysOfMonth(2).getCount(), 5);
+    EXPECT_EQ(f.findNextSunnyDay(Date(1, 1, 2024)).getDate(), Date(4, 1, 2024));
+    EXPECT_EQ(f.findNextSunnyDay(Date(1, 1, 2024)).getDate(), Date(4, 1, 2024));
+    EXPECT_EQ(f.getCacheHits(), 3);
+    EXPECT_EQ(f.getCacheMisses(), 3);
+    EXPECT_THROW(f.giveAllDaysOfMonth(5), std::runtime_error);
+    EXPECT_EQ(f.getCacheMisses(), 4);
+
+    uint64_t generation = f.getGeneration();
+    Weather cold; cold.setTemperature(-20);
+    PartsOfDay p; p.setMorning(cold); p.setDay(cold); p.setEvening(cold);
+    f += WeatherDay(Date(20, 2, 2024), 0.0, p);
+    EXPECT_GT(f.getGeneration(), generation);
+    EXPECT_EQ(f.findColdestDay(Date(1, 1, 2024), Date(1, 3, 2024)).averageTempOfDay(), -20);
+    EXPECT_EQ(f.giveAllDaysOfMonth(2).getCount(), 6);
+    EXPECT_EQ(f.getCacheHits(), 3);
+
+    f.deleteByIndex(f.getCount() - 1);
+    EXPECT_EQ(f.findColdestDay(Date(1, 1, 2024), Date(1, 3, 2024)).averageTempOfDay(), 1);
+    f[0] = WeatherDay(Date(1, 2, 2024), 0.0, p);
+    EXPECT_EQ(f.findColdestDay(Date(1, 1, 2024), Date(1, 3, 2024)).averageTempOfDay(), -20);
+    f.sortDaysByData();
+    EXPECT_EQ(f.findNextSunnyDay(Date(1, 1, 2024)).getDate(), Date(4, 1, 2024));
+
+    Forecast copy = f;
+    EXPECT_TRUE(copy.isQueryCacheEnabled());
+    EXPECT_EQ(copy.getCacheHits(), 0);
+    f.setQueryCache(false);
+    EXPECT_EQ(f.getCacheHits(), 0);
+}
+
+TEST(QueryCacheTest, SuspendedWhileMutableReferenceHeld) {
+    Forecast f;
+    for (int day = 1; day <= 5; ++day) {
+        Weather w; w.setTemperature(day);
+        PartsOfDay p; p.setMorning(w); p.setDay(w); p.setEvening(w);
+        f += WeatherDay(Date(day, 1, 2024), 0.0, p);
+    }
+    f.setQueryCache(true);
+    Date from(1, 12, 2023), to(1, 2, 2024);
+
+    // Ссылка, запрос, запись через ссылку, повторный запрос
+    WeatherDay& last = f[4];
+    EXPECT_EQ(f.findColdestDay(from, to).averageTempOfDay(), 1);
+    Weather cold; cold.setTemperature(-30);
+    PartsOfDay p; p.setMorning(cold); p.setDay(cold); p.setEvening(cold);
+    last = WeatherDay(Date(5, 1, 2024), 0.0, p);
+    EXPECT_EQ(f.findColdestDay(from, to).averageTempOfDay(), -30);
+    EXPECT_EQ(f.getCacheHits(), 0);
+
+    Forecast copy = f;
+    EXPECT_EQ(copy.findColdestDay(from, to).averageTempOfDay(), -30);
+    EXPECT_EQ(copy.findColdestDay(from, to).averageTempOfDay(), -30);
+    EXPECT_EQ(copy.getCacheHits(), 0);
+
+    f.setQueryCache(true);
+    EXPECT_EQ(f.findColdestDay(from, to).averageTempOfDay(), -30);
+    EXPECT_EQ(f.findColdestDay(from, to).averageTempOfDay(), -30);
+    EXPECT_EQ(f.getCacheHits(), 1);
+}
+
+TEST(ForecastStoreTest, PerStationQueriesAcrossShards) {
+    ForecastStore store(4);
+    EXPECT_THROW(ForecastStore(0), std::invalid_argument);
+    for (int station = 0; station < 20; ++station) {
+        for (int day = 1; day <= 5; ++day) {
+            Weather w; w.setTemperature(station + day);
+            PartsOfDay p; p.setMorning(w); p.setDay(w); p.setEvening(w);
+            int phenomen = day == 4 ? static_cast<int>(Phenomen::Sunny) : static_cast<int>(Phenomen::Cloudy);
+            store.add("ST" + std::to_string(station), WeatherDay(Date(day, 6, 2024), 0.0, p, phenomen));
+        }
+    }
+    store.add("EMPTY", WeatherDay(Date(1, 1, 1990), 0.0, PartsOfDay(), static_cast<int>(Phenomen::Cloudy)));
+    EXPECT_EQ(store.getStationCount(), 21);
+    EXPECT_TRUE(store.contains("ST7"));
+    EXPECT_EQ(store.getForecast("ST7").getCount(), 5);
+    EXPECT_THROW(store.getForecast("missing"), std::out_of_range);
+
+    auto coldest = store.findColdestDays(Date(1, 6, 2024), Date(10, 6, 2024));
+    ASSERT_EQ(coldest.size(), 20);
+    EXPECT_EQ(coldest.at("ST7").averageTempOfDay(), 9);
+    EXPECT_EQ(coldest.at("ST7").getDate(), Date(2, 6, 2024));
+
+    auto sunny = store.findNextSunnyDays(Date(1, 6, 2024));
+    ASSERT_EQ(sunny.size(), 20);
+    EXPECT_EQ(sunny.at("ST0").getDate(), Date(4, 6, 2024));
+
+    size_t days = 0;
+    size_t stations = 0;
+    for (const ShardUsage& usage : store.memoryUsage()) {
+        days += usage.days;
+        stations += usage.stations;
+        EXPECT_GE(usage.bytes, usage.days * sizeof(WeatherDay));
+    }
+    EXPECT_EQ(days, 101);
+    EXPECT_EQ(stations, 21);
+
+    store.update("ST7", [](Forecast& forecast) { forecast.deleteByIndex(0); });
+    EXPECT_EQ(store.getForecast("ST7").getCount(), 4);
+    EXPECT_TRUE(store.removeStation("ST7"));
+    EXPECT_FALSE(store.contains("ST7"));
+}
+
+TEST(ThreadPoolTest, AsyncResultsAndNestedTasks) {
+    ThreadPool pool(4);
+    EXPECT_EQ(pool.getThreadCount(), 4);
+    auto value = pool.async([]() { return 42; });
+    auto failed = pool.async([]() -> int { throw std::runtime_error("boom"); });
+    EXPECT_EQ(value.get(), 42);
+    EXPECT_THROW(failed.get(), std::runtime_error);
+
+    std::atomic<int> done{0};
+    auto outer = pool.async([&pool, &done]() {
+        for (int i = 0; i < 64; ++i) pool.submit([&done]() { done.fetch_add(1); });
+        while (done.load() < 64) pool.tryRunOne();
+    });
+    outer.get();
+    EXPECT_EQ(done.load(), 64);
+}
+
+TEST(BatchQueryTest, ResultsMatchSequentialOrder) {
+    std::vector<Forecast> forecasts(3);
+    for (size_t f = 0; f < forecasts.size(); ++f) {
+        for (int day = 1; day <= 28; ++day) {
+            Weather w; w.setTemperature(static_cast<int>((day * 7 + f * 5) % 31) - 10);
+            PartsOfDay p; p.setMorning(w); p.setDay(w); p.setEvening(w);
+            int phenomen = day % 9 == 0 ? static_cast<int>(Phenomen::Sunny) : static_cast<int>(Phenomen::Cloudy);
+            forecasts[f] += WeatherDay(Date(day, 1 + day % 3, 2024), 0.0, p, phenomen);
+        }
+    }
+    std::vector<ForecastQuery> queries;
+    for (int i = 0; i < 300; ++i) {
+        const Forecast* forecast = &forecasts[i % forecasts.size()];
+        switch (i % 4) {
+            case 0: queries.push_back(ColdestDayQuery{forecast, Date(1, 1, 2024), Date(1 + i % 28, 3, 2024)}); break;
+            case 1: queries.push_back(NextSunnyDayQuery{forecast, Date(1 + i % 28, 1, 2024)}); break;
+            case 2: queries.push_back(MonthQuery{forecast, static_cast<size_t>(1 + i % 3)}); break;
+            default: queries.push_back(ColdestDayQuery{forecast, Date(1, 1, 2030), Date(1, 1, 2031)}); break;
+        }
+    }
+    ThreadPool single(1);
+    EXPECT_THROW(runBatch(single, queries, 0), std::invalid_argument);
+
+    std::vector<QueryResult> expected;
+    for (const ForecastQuery& query : queries) expected.push_back(runQuery(query));
+    for (size_t threads : {1, 2, 8}) {
+        ThreadPool pool(threads);
+        for (size_t grain : {1, 7, 64}) {
+            std::vector<QueryResult> results = runBatch(pool, queries, grain);
+            ASSERT_EQ(results.size(), expected.size());
+            for (size_t i = 0; i < results.size(); ++i) {
+                ASSERT_EQ(results[i].value.index(), expected[i].value.index());
+                EXPECT_EQ(results[i].error == nullptr, expected[i].error == nullptr);
+                if (auto day = std::get_if<WeatherDay>(&results[i].value)) {
+                    EXPECT_EQ(day->getDate(), std::get<WeatherDay>(expected[i].value).getDate());
+                } else if (auto month = std::get_if<Forecast>(&results[i].value)) {
+                    EXPECT_EQ(month->getCount(), std::get<Forecast>(expected[i].value).getCount());
+                }
+            }
+        }
+    }
+    EXPECT_NE(expected[3].error, nullptr);
+    EXPECT_THROW(std::rethrow_exception(expected[3].error), std::runtime_error);
+}
+
+TEST(AsyncForecastTest, AwaitableQueriesMatchBlocking) {
+    std::istringstream text(
+        "22.01.2026 0.0 5 7 3\n"
+        "12.03.2026 2.5 -1 1 -3\n"
+        "24.01.2026 10.0 -5 -2 -8\n"
+        "05.01.2026 0.0 10 12 8\n"
+        "26.03.2026 1.2 0 2 -1\n"
+        "broken line\n"
+        "27.03.2026 1.2 0 2 -1\n");
+    Forecast f;
+    ImportResult imported = importForecast(text, f);
+    EXPECT_EQ(imported.imported, 6);
+    EXPECT_EQ(imported.rejected, 1);
+    f.setLazyDeletion(true);
+    f.deleteByIndex(3);
+
+    WeatherDay coldest = syncWait(findColdestDayAsync(f, Date(1, 1, 2026), Date(1, 4, 2026)));
+    EXPECT_EQ(coldest.getDate(), f.findColdestDay(Date(1, 1, 2026), Date(1, 4, 2026)).getDate());
+    EXPECT_THROW(syncWait(findColdestDayAsync(f, Date(1, 1, 2030), Date(1, 4, 2030))), std::runtime_error);
+    EXPECT_THROW(syncWait(findColdestDayAsync(Forecast(), Date(1, 1, 2026), Date(1, 4, 2026))), std::invalid_argument);
+
+    Forecast january = syncWait(giveAllDaysOfMonthAsync(f, 1));
+    ASSERT_EQ(january.getCount(), 2);
+    EXPECT_EQ(january[0].getDate(), Date(22, 1, 2026));
+    EXPECT_THROW(syncWait(giveAllDaysOfMonthAsync(f, 13)), std::invalid_argument);
+
+    Forecast sorted = syncWait(sortAsync(f));
+    EXPECT_TRUE(sorted.isSorted());
+    EXPECT_FALSE(f.isSorted());
+    Forecast merged = syncWait(mergeAsync(f, january));
+    EXPECT_EQ(merged.getCount(), 5);
+    EXPECT_TRUE(merged.isSorted());
+
+    // Корутины вызывающего кода ожидают операции подряд
+    auto pipeline = [](Forecast source) -> Task<int> {
+        Forecast march = co_await giveAllDaysOfMonthAsync(source, 3);
+        WeatherDay day = co_await findColdestDayAsync(march, Date(1, 3, 2026), Date(31, 3, 2026));
+        co_return day.averageTempOfDay();
+    };
+    EXPECT_EQ(syncWait(pipeline(f)), -1);
+}
+
+TEST(AsyncForecastTest, CancellationStopsOperations) {
+    Forecast f;
+    for (int i = 0; i < 10000; ++i) {
+        f += WeatherDay(Date(1 + i % 28, 1 + i % 12, 2000 + i / 336), 0.0, PartsOfDay());
+    }
+    std::stop_source source;
+    source.request_stop();
+    EXPECT_THROW(syncWait(findColdestDayAsync(f, Date(1, 1, 1999), Date(1, 1, 2100), source.get_token())), OperationCancelled);
+    EXPECT_THROW(syncWait(giveAllDaysOfMonthAsync(f, 2, source.get_token())), OperationCancelled);
+    EXPECT_THROW(syncWait(sortAsync(f, source.get_token())), OperationCancelled);
+    EXPECT_THROW(syncWait(importForecastAsync("missing-file.txt")), std::runtime_error);
+
+    std::istringstream text("22.01.2026 0.0 5 7 3\n23.01.2026 2.5 -1 1 -3\n");
+    Forecast partial;
+    EXPECT_EQ(importForecast(text, partial, source.get_token()).imported, 0);
+}
+
+#ifdef __unix__
+TEST(SharedForecastTest, ReaderQueriesPublishedVersion) {
+    const std::string name = "/weather_lib_test_" + std::to_string(::getpid());
+    EXPECT_THROW(SharedForecastPublisher(name, 0), std::invalid_argument);
+    SharedForecastPublisher publisher(name, 64);
+    SharedForecastReader reader(name);
+    EXPECT_EQ(reader.getGeneration(), 0);
+    EXPECT_EQ(reader.getCount(), 0);
+    EXPECT_THROW(reader.findColdestDay(Date(1, 1, 2024), Date(1, 1, 2025)), std::invalid_argument);
+
+    Forecast f;
+    for (int day = 1; day <= 20; ++day) {
+        Weather w; w.setTemperature((day * 13) % 40 - 5);
+        PartsOfDay p; p.setMorning(w); p.setDay(w); p.setEvening(w);
+        int phenomen = day % 5 == 0 ? static_cast<int>(Phenomen::Sunny) : static_cast<int>(Phenomen::Rainy);
+        f += WeatherDay(Date(day, 1 + day % 2, 2024), 0.5 * day, p, phenomen);
+    }
+    publisher.publish(f);
+    EXPECT_EQ(reader.getGeneration(), 1);
+    ASSERT_EQ(reader.getCount(), 20);
+    EXPECT_EQ(reader.at(3).getDate(), f[3].getDate());
+    EXPECT_DOUBLE_EQ(reader.at(3).getPrecipitation(), f[3].getPrecipitation());
+    EXPECT_EQ(reader.at(3).getPhenomen(), f[3].getPhenomen());
+    EXPECT_THROW(reader.at(20), std::out_of_range);
+    EXPECT_EQ(reader.findColdestDay(Date(1, 1, 2024), Date(1, 3, 2024)).getDate(),
+              f.findColdestDay(Date(1, 1, 2024), Date(1, 3, 2024)).getDate());
+    EXPECT_EQ(reader.findNextSunnyDay(Date(1, 1, 2024)).getDate(), f.findNextSunnyDay(Date(1, 1, 2024)).getDate());
+    EXPECT_EQ(reader.giveAllDaysOfMonth(2).getCount(), f.giveAllDaysOfMonth(2).getCount());
+    EXPECT_THROW(reader.giveAllDaysOfMonth(5), std::runtime_error);
+
+    // Новая версия видна целиком, старый буфер остаётся нетронутым до следующей публикации
+    f.setLazyDeletion(true);
+    f.deleteByIndex(0);
+    publisher.publish(f);
+    EXPECT_EQ(reader.getGeneration(), 2);
+    EXPECT_EQ(reader.getCount(), 19);
+    EXPECT_EQ(reader.at(0).getDate(), f[0].getDate());
+    Forecast oversized;
+    oversized.append(std::vector<WeatherDay>(65));
+    EXPECT_THROW(publisher.publish(oversized), std::invalid_argument);
+    EXPECT_THROW(SharedForecastReader("/weather_lib_missing_segment"), std::runtime_error);
+}
+TEST(SharedForecastTest, QueriesStayConsistentWhileWriterRepublishes) {
+    const std::string name = "/weather_lib_test_race_" + std::to_string(::getpid());
+    GeneratorOptions options;
+    options.mean_temperature = 35;
+    options.seasonal_amplitude = 0;
+    Forecast versions[2];
+    options.seed = 1;
+    versions[0] = ForecastGenerator(options).makeForecast(64, true);
+    options.seed = 2;
+    options.start = Date(1, 6, 2001);
+    versions[1] = ForecastGenerator(options).makeForecast(48, true);
+
+    SharedForecastPublisher publisher(name, 64);
+    SharedForecastReader reader(name);
+    publisher.publish(versions[0]);
+    Date from(1, 1, 1999), to(1, 1, 2003);
+    std::atomic<bool> done{false};
+    std::thread writer([&]() {
+        for (int i = 1; i <= 2000; ++i) publisher.publish(versions[i % 2]);
+        done = true;
+    });
+    size_t rounds = 0;
+    while (!done || rounds == 0) {
+        size_t count = reader.getCount();
+        EXPECT_TRUE(count == 64 || count == 48);
+        Date sunny = reader.findNextSunnyDay(from).getDate();
+        EXPECT_TRUE(sunny == versions[0].findNextSunnyDay(from).getDate()
+                    || sunny == versions[1].findNextSunnyDay(from).getDate());
+        Date coldest = reader.findColdestDay(from, to).getDate();
+        EXPECT_TRUE(coldest == versions[0].findColdestDay(from, to).getDate()
+                    || coldest == versions[1].findColdestDay(from, to).getDate());
+        rounds++;
+    }
+    writer.join();
+    EXPECT_EQ(reader.getGeneration(), 2001);
+}
+#endif
+
+TEST(ExpectedApiTest, TryMethodsReportErrorCodes) {
+    EXPECT_EQ(Date::tryMake(32, 1, 2024).error(), WeatherError::InvalidDay);
+    EXPECT_EQ(Date::tryMake(1, 13, 2024).error(), WeatherError::InvalidMonth);
+    EXPECT_EQ(Date::tryMake(1, 1, 10000).error(), WeatherError::InvalidYear);
+    EXPECT_EQ(Date::tryMake(5, 6, 2024).value(), Date(5, 6, 2024));
+    EXPECT_EQ(Weather::tryMake(-300).error(), WeatherError::InvalidTemperature);
+    EXPECT_EQ(WeatherDay::tryMake(Date(), -1.0, PartsOfDay()).error(), WeatherError::InvalidPrecipitation);
+    EXPECT_EQ(Forecast::tryMake(0).error(), WeatherError::InvalidCapacity);
+    EXPECT_THROW(Forecast(0), std::invalid_argument);
+
+    Forecast f;
+    EXPECT_EQ(f.tryFindColdestDay(Date(1, 1, 2024), Date(1, 1, 2025)).error(), WeatherError::EmptyData);
+    f += WeatherDay(Date(10, 1, 2024), 0.0, PartsOfDay());
+    EXPECT_EQ(f.tryFindColdestDay(Date(1, 1, 2030), Date(1, 1, 2031)).error(), WeatherError::NotFound);
+    EXPECT_EQ(f.tryGiveAllDaysOfMonth(13).error(), WeatherError::InvalidMonth);
+    EXPECT_EQ(f.tryGiveAllDaysOfMonth(1)->getCount(), 1);
+    EXPECT_EQ(f.tryDeleteByIndex(5).error(), WeatherError::InvalidIndex);
+    EXPECT_TRUE(f.tryDeleteByIndex(0).has_value());
+    EXPECT_STREQ(errorMessage(WeatherError::NotFound), "NOT FOUND\n");
+}
+
+TEST(ExpectedApiTest, ImporterSkipsInvalidRecords) {
+    EXPECT_EQ(parseWeatherDay("12.03.2026 2.5 -1 1 -3")->getDate(), Date(12, 3, 2026));
+    EXPECT_EQ(parseWeatherDay("12.03.2026 2.5 -1 1").error(), WeatherError::ParseError);
+    EXPECT_EQ(parseWeatherDay("12.03.2026 2.5 -1 1 -3 7").error(), WeatherError::ParseError);
+    EXPECT_EQ(parseWeatherDay("40.03.2026 2.5 -1 1 -3").error(), WeatherError::InvalidDay);
+    EXPECT_EQ(parseWeatherDay("12.03.2026 -2.5 -1 1 -3").error(), WeatherError::InvalidPrecipitation);
+    EXPECT_EQ(parseWeatherDay("12.03.2026 nan -1 1 -3").error(), WeatherError::InvalidPrecipitation);
+    EXPECT_EQ(parseWeatherDay("12.03.2026 inf -1 1 -3").error(), WeatherError::InvalidPrecipitation);
+    EXPECT_EQ(parseWeatherDay("12.03.2026 2.5 -300 1 -3").error(), WeatherError::InvalidTemperature);
+
+    std::istringstream text(
+        "22.01.2026 0.0 5 7 3\n"
+        "\n"
+        "32.02.2026 0.0 5 7 3\n"
+        "23.01.2026 abc 5 7 3\n"
+        "24.01.2026 1.0 -5 -2 -8\n");
+    Forecast f;
+    ImportResult result = importForecast(text, f);
+    EXPECT_EQ(result.imported, 2);
+    EXPECT_EQ(result.rejected, 2);
+    ASSERT_EQ(f.getCount(), 2);
+    EXPECT_EQ(f[1].getDate(), Date(24, 1, 2026));
+    EXPECT_EQ(f[1].getPrecipitation(), 1.0);
+}
+
+TEST(ForecastGeneratorTest, DeterministicAndRoundTripsThroughImport) {
+    GeneratorOptions options;
+    options.seed = 7;
+    options.duplicate_ratio = 0.25;
+    options.error_ratio = 0.5;
+    ForecastGenerator generator(options);
+    std::vector<WeatherDay> days = generator.generate(0, 1000);
+    std::vector<WeatherDay> tail = ForecastGenerator(options).generate(600, 400);
+    size_t duplicates = 0, errors = 0;
+    for (size_t i = 0; i != days.size(); ++i) {
+        if (i >= 600) {
+            EXPECT_EQ(days[i].getDate(), tail[i - 600].getDate());
+        }
+        if (i > 0 && days[i].getDate() == days[i - 1].getDate()) duplicates++;
+        if (!days[i].check()) errors++;
+    }
+    EXPECT_EQ(duplicates, 250);
+    EXPECT_NEAR(errors, 500, 60);
+    Forecast clean = ForecastGenerator().makeForecast(1000);
+    clean.deleteAllErrors();
+    EXPECT_EQ(clean.getCount(), 1000);
+    EXPECT_TRUE(generator.makeForecast(1000).isSorted());
+    EXPECT_THROW(ForecastGenerator(GeneratorOptions{.duplicate_ratio = 1.0}), std::invalid_argument);
+
+    std::string text;
+    char record[MAX_RECORD_LENGTH];
+    for (const WeatherDay& day : days) text.append(record, formatWeatherDay(day, record)) += '\n';
+    std::istringstream in(text);
+    Forecast imported;
+    EXPECT_EQ(importForecast(in, imported).imported, days.size());
+    for (size_t i = 0; i != days.size(); ++i) {
+        EXPECT_EQ(imported[i].getDate(), days[i].getDate());
+        EXPECT_EQ(imported[i].getPrecipitation(), days[i].getPrecipitation());
+        EXPECT_EQ(imported[i].getPartsOfDay().getEvening().getTemperature(), days[i].getPartsOfDay().getEvening().getTemperature());
+    }
+}
+
+TEST(ForecastGeneratorTest, StationsSpanAndBinaryFormat) {
+    GeneratorOptions options;
+    options.stations = 3;
+    options.span_days = 10;
+    ForecastGenerator generator(options);
+    std::vector<WeatherDay> days = generator.generate(0, 60);
+    EXPECT_EQ(days[0].getDate(), days[2].getDate());
+    EXPECT_EQ(days[3].getDate(), Date(2, 1, 2000));
+    EXPECT_EQ(days[30].getDate(), days[0].getDate());
+    EXPECT_THROW(ForecastGenerator(GeneratorOptions{.stations = 0}), std::invalid_argument);
+
+    // Без span_days даты заворачиваются после 31.12.9999, а не выходят за диапазон Date
+    ForecastGenerator unbounded;
+    EXPECT_EQ(unbounded.at(2921939).getDate(), Date(31, 12, 9999));
+    EXPECT_EQ(unbounded.at(2921940).getDate(), Date(1, 1, 2000));
+    EXPECT_NO_THROW(unbounded.generate(10000000, 10));
+
+    std::stringstream file(std::ios::in | std::ios::out | std::ios::binary);
+    BinaryHeader header{};
+    std::copy(std::begin(BINARY_MAGIC), std::end(BINARY_MAGIC), header.magic);
+    header.count = days.size() + 1;
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    for (const WeatherDay& day : days) {
+        BinaryRecord record = toBinaryRecord(day);
+        file.write(reinterpret_cast<const char*>(&record), sizeof(record));
+    }
+    BinaryRecord broken = toBinaryRecord(days[0]);
+    broken.month = 13;
+    file.write(reinterpret_cast<const char*>(&broken), sizeof(broken));
+
+    Forecast imported;
+    ImportResult result = importBinaryForecast(file, imported);
+    EXPECT_EQ(result.imported, days.size());
+    EXPECT_EQ(result.rejected, 1);
+    EXPECT_EQ(imported[59].getDate(), days[59].getDate());
+    EXPECT_EQ(imported[59].getPhenomen(), days[59].getPhenomen());
+    EXPECT_EQ(imported[59].getPartsOfDay().getMorning().getTemperature(), days[59].getPartsOfDay().getMorning().getTemperature());
+
+    std::istringstream garbage("not a forecast file");
+    EXPECT_THROW(importBinaryForecast(garbage, imported), std::runtime_error);
+}
+
+TEST(ForecastMetricsTest, CountersTrackHotPaths) {
+    resetMetrics();
+    Forecast f(2);
+    for (int day = 20; day >= 1; --day) f.append(std::vector<WeatherDay>{WeatherDay(Date(day, 1, 2024), 0.0, PartsOfDay())});
+    f.sortDaysByData();
+    f.deleteByIndex(0);
+    f.setQueryCache(true);
+    f.findColdestDay(Date(1, 1, 2024), Date(1, 2, 2024));
+    f.findColdestDay(Date(1, 1, 2024), Date(1, 2, 2024));
+    f.giveAllDaysOfMonth(1);
+    Forecast copy = f;
+    copy.deleteByIndex(0);
+
+    MetricsSnapshot snapshot = metricsSnapshot();
+    std::string json = formatMetricsJson(snapshot);
+    EXPECT_NE(formatMetricsText(snapshot).find("delete_shifts "), std::string::npos);
+    EXPECT_NE(json.find("\"scanned_coldest_day\":"), std::string::npos);
+    if constexpr (METRICS_ENABLED) {
+        EXPECT_EQ(json.find("{\"enabled\":true"), 0);
+        EXPECT_GE(snapshot[Metric::Resizes], 4);
+        EXPECT_GT(snapshot[Metric::ResizeBytesCopied], 0);
+        EXPECT_EQ(snapshot[Metric::Detaches], 1);
+        EXPECT_EQ(snapshot[Metric::DetachBytesCopied], 19 * sizeof(WeatherDay));
+        EXPECT_EQ(snapshot[Metric::DeleteShifts], 19 + 18);
+        EXPECT_EQ(snapshot[Metric::Sorts], 1);
+        EXPECT_EQ(snapshot[Metric::ScannedColdestDay], 19);
+        EXPECT_EQ(snapshot[Metric::ScannedDaysOfMonth], 19);
+        EXPECT_EQ(snapshot[Metric::CacheHits], 1);
+        EXPECT_EQ(snapshot[Metric::CacheMisses], 2);
+    } else {
+        EXPECT_EQ(json.find("{\"enabled\":false"), 0);
+        for (uint64_t value : snapshot.values) EXPECT_EQ(value, 0);
+    }
+    resetMetrics();
+    EXPECT_EQ(metricsSnapshot()[Metric::Sorts], 0);
+}
+
+TEST(TraceTest, SpansFromAllThreadsFormChromeTrace) {
+    clearTrace();
+    Forecast idle = ForecastGenerator().makeForecast(100, true);
+    idle.sortDaysByData();
+    std::ostringstream empty;
+    writeTrace(empty);
+    EXPECT_EQ(empty.str().find("Forecast::sortDaysByData"), std::string::npos);
+
+    startTracing();
+    EXPECT_TRUE(isTracing());
+    Forecast f = ForecastGenerator().makeForecast(1000, true);
+    f.sortDaysByData();
+    f.findColdestDay(Date(1, 1, 2000), Date(1, 1, 2001));
+    std::thread worker([&f]() { f.giveAllDaysOfMonth(3); });
+    worker.join();
+    stopTracing();
+    f.deleteAllErrors();
+
+    std::ostringstream out;
+    writeTrace(out);
+    std::string json = out.str();
+    EXPECT_EQ(json.find("{\"displayTimeUnit\":\"ms\",\"traceEvents\":["), 0);
+    EXPECT_NE(json.find("\"name\":\"Forecast::sortDaysByData\",\"cat\":\"forecast\",\"ph\":\"X\""), std::string::npos);
+    EXPECT_NE(json.find("\"name\":\"Forecast::findColdestDay\",\"cat\":\"query\""), std::string::npos);
+    EXPECT_NE(json.find("Forecast::resize"), std::string::npos);
+    EXPECT_EQ(json.find("Forecast::deleteAllErrors"), std::string::npos);
+    size_t month = json.find("Forecast::giveAllDaysOfMonth");
+    size_t sort = json.find("Forecast::sortDaysByData");
+    ASSERT_NE(month, std::string::npos);
+    std::string month_tid = json.substr(json.find("\"tid\":", month), 10);
+    std::string sort_tid = json.substr(json.find("\"tid\":", sort), 10);
+    EXPECT_NE(month_tid, sort_tid);
+
+    clearTrace();
+    std::ostringstream cleared;
+    writeTrace(cleared);
+    EXPECT_EQ(cleared.str().find("Forecast::"), std::string::npos);
+}
+
+TEST(LoggingTest, CategorySinksAndSilentAppend) {
+    std::vector<std::string> captured;
+    setLogSink(LogCategory::Io, [&captured](LogLevel level, LogCategory category, std::string_view message) {
+        captured.push_back(std::string(logLevelName(level)) + " " + logCategoryName(category) + " " + std::string(message));
+    });
+    setLogSink(LogCategory::Forecast, nullptr);
+    logMessage<LogLevel::Error>(LogCategory::Io, "records: ", 42);
+    logMessage<LogLevel::Error>(LogCategory::Forecast, "dropped");
+    logMessage<LogLevel::Trace>(LogCategory::Io, "hot path");
+    if constexpr (isLogLevelCompiled(LogLevel::Error)) {
+        ASSERT_EQ(captured.size(), isLogLevelCompiled(LogLevel::Trace) ? 2 : 1);
+        EXPECT_EQ(captured[0], "ERROR io records: 42");
+    }
+
+    std::ostringstream out;
+    std::streambuf* original = std::cout.rdbuf(out.rdbuf());
+    Forecast f;
+    for (int day = 1; day <= 10; ++day) f += WeatherDay(Date(day, 1, 2024), 0.0, PartsOfDay());
+    std::cout.rdbuf(original);
+    EXPECT_TRUE(out.str().empty());
+    EXPECT_EQ(f.getCount(), 10);
+
+    setLogSink(LogCategory::Io, stderrLogSink());
+    setLogSink(LogCategory::Forecast, stderrLogSink());
+}
+
+namespace {
+    class CountingResource : public std::pmr::memory_resource {
+    public:
+        size_t allocations = 0;
+        size_t live_bytes = 0;
+
+    private:
+        void* do_allocate(size_t bytes, size_t alignment) override {
+            allocations++;
+            live_bytes += bytes;
+            return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+        }
+
+        void do_deallocate(void* pointer, size_t bytes, size_t alignment) override {
+            live_bytes -= bytes;
+            std::pmr::new_delete_resource()->deallocate(pointer, bytes, alignment);
+        }
+
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+            return this == &other;
+        }
+    };
+}
+
+TEST(ForecastMemoryUsageTest, PmrResourceAndBreakdown) {
+    CountingResource counting;
+    EXPECT_THROW(Forecast(4, nullptr), std::invalid_argument);
+    {
+        Forecast f(4, &counting);
+        EXPECT_EQ(f.getMemoryResource(), &counting);
+        f.append(ForecastGenerator().generate(0, 100));
+        EXPECT_GE(counting.allocations, 2);
+        EXPECT_GE(counting.live_bytes, f.getCapacity() * sizeof(WeatherDay));
+
+        MemoryUsage usage = f.memoryUsage();
+        EXPECT_EQ(usage.live_bytes, 100 * sizeof(WeatherDay));
+        EXPECT_EQ(usage.slack_bytes, (f.getCapacity() - 100) * sizeof(WeatherDay));
+        EXPECT_EQ(usage.index_bytes, 0);
+        EXPECT_EQ(usage.buffer_owners, 1);
+
+        Forecast shared = f;
+        EXPECT_EQ(f.memoryUsage().buffer_owners, 2);
+        shared += WeatherDay(Date(1, 1, 2030), 0.0, PartsOfDay());
+        EXPECT_EQ(shared.getMemoryResource(), &counting);
+        EXPECT_EQ(f.memoryUsage().buffer_owners, 1);
+
+        size_t before = counting.allocations;
+        Forecast detached(f, std::pmr::new_delete_resource());
+        EXPECT_EQ(counting.allocations, before);
+        EXPECT_EQ(detached.getCount(), 100);
+        EXPECT_EQ(detached[99].getDate(), f[99].getDate());
+
+        f.setLazyDeletion(true);
+        f.deleteByIndex(10);
+        usage = f.memoryUsage();
+        EXPECT_EQ(usage.live_bytes, 99 * sizeof(WeatherDay));
+        EXPECT_EQ(usage.tombstone_bytes, sizeof(WeatherDay));
+        EXPECT_GT(usage.index_bytes, 0);
+        EXPECT_EQ(usage.live_bytes + usage.tombstone_bytes + usage.slack_bytes, f.getCapacity() * sizeof(WeatherDay));
+
+        f.setQueryCache(true);
+        f.giveAllDaysOfMonth(1);
+        EXPECT_GT(f.memoryUsage().cache_bytes, 0);
+    }
+    EXPECT_EQ(counting.live_bytes, 0);
+}
+
+TEST(ForecastMemoryUsageTest, MonthQueryIntoArena) {
+    Forecast f = ForecastGenerator().makeForecast(2000, true);
+    Forecast expected = f.giveAllDaysOfMonth(3);
+    EXPECT_TRUE(expected.isSorted());
+    for (size_t i = 1; i < expected.getCount(); ++i) {
+        EXPECT_FALSE(expected[i].getDate() < expected[i - 1].getDate());
+    }
+
+    CountingResource counting;
+    {
+        std::pmr::monotonic_buffer_resource arena(&counting);
+        Forecast month = f.giveAllDaysOfMonth(3, &arena);
+        EXPECT_EQ(month.getMemoryResource(), &arena);
+        ASSERT_EQ(month.getCount(), expected.getCount());
+        EXPECT_EQ(month.getCapacity(), month.getCount());
+        for (size_t i = 0; i < month.getCount(); ++i) EXPECT_EQ(month[i].getDate(), expected[i].getDate());
+        EXPECT_GT(counting.allocations, 0);
+
+        f.setQueryCache(true);
+        Forecast cached = f.giveAllDaysOfMonth(3, &arena);
+        Forecast again = f.giveAllDaysOfMonth(3, &arena);
+        EXPECT_EQ(again.getMemoryResource(), &arena);
+        EXPECT_EQ(again.getCount(), expected.getCount());
+        EXPECT_EQ(f.getCacheHits(), 1);
+        EXPECT_EQ(f.tryGiveAllDaysOfMonth(13, &arena).error(), WeatherError::InvalidMonth);
+    }
+    EXPECT_EQ(counting.live_bytes, 0);
+}
+
+TEST(PackedForecastTest, LosslessRoundTripAndQueries) {
+    GeneratorOptions options;
+    options.error_ratio = 0.2;
+    options.duplicate_ratio = 0.1;
+    Forecast source = ForecastGenerator(options).makeForecast(1000, true);
+    PackedForecast packed(source);
+    ASSERT_EQ(packed.getCount(), source.getCount());
+    EXPECT_EQ(packed.memoryBytes(), source.getCount() * 16);
+    for (size_t i = 0; i < source.getCount(); ++i) {
+        WeatherDay day = packed[i];
+        EXPECT_EQ(day.getDate(), source[i].getDate());
+        EXPECT_EQ(day.getPrecipitation(), source[i].getPrecipitation());
+        EXPECT_EQ(day.getPhenomen(), source[i].getPhenomen());
+        EXPECT_EQ(day.getPartsOfDay().getMorning().getTemperature(), source[i].getPartsOfDay().getMorning().getTemperature());
+        EXPECT_EQ(day.getPartsOfDay().getDay().getTemperature(), source[i].getPartsOfDay().getDay().getTemperature());
+        EXPECT_EQ(day.getPartsOfDay().getEvening().getTemperature(), source[i].getPartsOfDay().getEvening().getTemperature());
+    }
+
+    Date from(10, 2, 2000), to(20, 11, 2001);
+    EXPECT_EQ(packed.findColdestDay(from, to).getDate(), source.findColdestDay(from, to).getDate());
+    EXPECT_EQ(packed.findNextSunnyDay(from).getDate(), source.findNextSunnyDay(from).getDate());
+    Forecast month = packed.giveAllDaysOfMonth(7);
+    Forecast expected = source.giveAllDaysOfMonth(7);
+    ASSERT_EQ(month.getCount(), expected.getCount());
+    for (size_t i = 0; i < month.getCount(); ++i) EXPECT_EQ(month[i].getDate(), expected[i].getDate());
+    EXPECT_EQ(packed.toForecast().getCount(), source.getCount());
+
+    EXPECT_LT(PackedWeatherDay::pack(WeatherDay(Date(31, 12, -5), 0, PartsOfDay())).dateKey(),
+              PackedWeatherDay::pack(WeatherDay(Date(1, 1, 3), 0, PartsOfDay())).dateKey());
+}
+
+TEST(PackedForecastTest, RejectsValuesOutsidePackedRange) {
+    PackedForecast packed;
+    WeatherDay fractional(Date(1, 1, 2000), 0.125, PartsOfDay());
+    EXPECT_EQ(packed.tryAppend(fractional).error(), WeatherError::NotRepresentable);
+    EXPECT_THROW(packed += fractional, std::invalid_argument);
+
+    PartsOfDay hot;
+    Weather weather;
+    weather.setTemperature(40000);
+    hot.setDay(weather);
+    EXPECT_EQ(packed.tryAppend(WeatherDay(Date(1, 1, 2000), 0, hot)).error(), WeatherError::NotRepresentable);
+    EXPECT_EQ(packed.tryAppend(WeatherDay(Date(1, 1, 2000), 0, PartsOfDay(), 7)).error(), WeatherError::NotRepresentable);
+    EXPECT_EQ(packed.getCount(), 0);
+
+    EXPECT_TRUE(packed.tryAppend(WeatherDay(Date(2, 1, 2000), 1500.05, PartsOfDay())).has_value());
+    EXPECT_EQ(packed[0].getPrecipitation(), 1500.05);
+    EXPECT_THROW(packed[1], std::out_of_range);
+    EXPECT_THROW(PackedForecast().findColdestDay(Date(1, 1, 2000), Date(1, 1, 2001)), std::invalid_argument);
+}
+
+TEST(ForecastArchiveTest, CompressedBlocksRoundTripAndSeek) {
+    GeneratorOptions options;
+    options.error_ratio = 0.05;
+    options.duplicate_ratio = 0.1;
+    Forecast source = ForecastGenerator(options).makeForecast(3000, false);
+    source += WeatherDay(Date(1, 1, 2100), 0.125, PartsOfDay());
+    ForecastArchive archive(source, 512);
+    ASSERT_EQ(archive.getCount(), source.getCount());
+    ASSERT_EQ(archive.blocks().size(), 6);
+
+    Forecast restored = archive.toForecast();
+    ASSERT_EQ(restored.getCount(), source.getCount());
+    size_t text_bytes = 0;
+    char record[MAX_RECORD_LENGTH];
+    for (size_t i = 0; i < source.getCount(); ++i) {
+        text_bytes += formatWeatherDay(source[i], record) - record + 1;
+        EXPECT_EQ(restored[i].getDate(), source[i].getDate());
+        EXPECT_EQ(restored[i].getPrecipitation(), source[i].getPrecipitation());
+        EXPECT_EQ(restored[i].getPhenomen(), source[i].getPhenomen());
+        EXPECT_EQ(restored[i].getPartsOfDay().getEvening().getTemperature(), source[i].getPartsOfDay().getEvening().getTemperature());
+    }
+    EXPECT_GE(text_bytes, archive.compressedBytes() * 5);
+
+    // Блок декодируется без остальных данных архива
+    std::vector<uint8_t> copy(archive.blockData(3).begin(), archive.blockData(3).end());
+    std::vector<WeatherDay> block;
+    EXPECT_EQ(decodeArchiveBlock(copy, block), 512);
+    EXPECT_EQ(block.front().getDate(), source[3 * 512].getDate());
+
+    Date from(15, 3, 2001), to(2, 4, 2001);
+    std::vector<WeatherDay> range = archive.decodeRange(from, to);
+    size_t expected = 0;
+    for (size_t i = 0; i < source.getCount(); ++i) {
+        if (!(source[i].getDate() < from) && !(to < source[i].getDate())) expected++;
+    }
+    EXPECT_EQ(range.size(), expected);
+    EXPECT_GT(range.size(), 0);
+    EXPECT_EQ(archive.findColdestDay(from, to).getDate(), source.findColdestDay(from, to).getDate());
+    EXPECT_EQ(archive.findColdestDay(Date(1, 1, 1999), Date(1, 1, 2101)).getDate(),
+              source.findColdestDay(Date(1, 1, 1999), Date(1, 1, 2101)).getDate());
+    EXPECT_THROW(archive.findColdestDay(Date(1, 1, 1990), Date(2, 1, 1990)), std::runtime_error);
+
+    std::stringstream file;
+    archive.write(file);
+    ForecastArchive loaded = ForecastArchive::read(file);
+    EXPECT_EQ(loaded.getCount(), archive.getCount());
+    EXPECT_EQ(loaded.decodeRange(from, to).size(), expected);
+
+    copy.pop_back();
+    EXPECT_THROW(decodeArchiveBlock(copy, block), std::runtime_error);
+    Forecast unsorted;
+    unsorted += WeatherDay(Date(2, 1, 2000), 0, PartsOfDay());
+    unsorted += WeatherDay(Date(1, 1, 2000), 0, PartsOfDay());
+    EXPECT_THROW(ForecastArchive archive2(unsorted), std::invalid_argument);
+}
+
+TEST(ForecastArchiveTest, CorruptedFieldsThrowRuntimeError) {
+    // Блок из одного сухого дня без исключений явлений, собранный вручную
+    auto block = [](int64_t key, int64_t morning) {
+        std::vector<uint8_t> out;
+        auto varint = [&out](uint64_t value) {
+            for (; value >= 0x80; value >>= 7) out.push_back(static_cast<uint8_t>(value) | 0x80);
+            out.push_back(static_cast<uint8_t>(value));
+        };
+        auto zigzag = [](int64_t value) { return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63); };
+        varint(1);
+        varint(zigzag(key));
+        varint(zigzag(morning));
+        varint(zigzag(0));
+        varint(zigzag(0) << 1 | 1);
+        varint(1 << 3);
+        return out;
+    };
+    std::vector<WeatherDay> days;
+    ASSERT_EQ(decodeArchiveBlock(block(2024 * 512 + 3 * 32 + 12, -5), days), 1);
+    EXPECT_EQ(days[0].getDate(), Date(12, 3, 2024));
+    EXPECT_EQ(days[0].getPartsOfDay().getMorning().getTemperature(), -5);
+
+    EXPECT_THROW(decodeArchiveBlock(block(2024 * 512 + 13 * 32 + 12, -5), days), std::runtime_error);
+    EXPECT_THROW(decodeArchiveBlock(block(10000 * 512 + 32 + 1, -5), days), std::runtime_error);
+    EXPECT_THROW(decodeArchiveBlock(block(-1000 * 512 + 32 + 1, -5), days), std::runtime_error);
+    EXPECT_THROW(decodeArchiveBlock(block(2024 * 512 + 3 * 32 + 12, -300), days), std::runtime_error);
+    EXPECT_THROW(decodeArchiveBlock(block(2024 * 512 + 3 * 32 + 12, int64_t(1) << 40), days), std::runtime_error);
+    EXPECT_EQ(days.size(), 1);
+
+    std::stringstream file;
+    ForecastArchive(ForecastGenerator().makeForecast(10)).write(file);
+    std::string bytes = file.str();
+    int32_t month_13 = 2000 * 512 + 13 * 32 + 1;
+    std::memcpy(bytes.data() + 8 + 2 * sizeof(uint64_t), &month_13, sizeof(month_13));
+    std::stringstream corrupted(bytes);
+    EXPECT_THROW(ForecastArchive::read(corrupted), std::runtime_error);
+}
+
+TEST(RollingForecastTest, EvictsOldestAndQueriesAcrossWrap) {
+    EXPECT_THROW(RollingForecast(0), std::invalid_argument);
+    std::vector<WeatherDay> days = ForecastGenerator().generate(0, 12);
+    RollingForecast window(5);
+    for (size_t i = 0; i < 3; ++i) window += days[i];
+    EXPECT_EQ(window.getCount(), 3);
+    EXPECT_FALSE(window.isFull());
+    EXPECT_TRUE(window.segments()[1].empty());
+
+    for (size_t i = 3; i < days.size(); ++i) window += days[i];
+    ASSERT_EQ(window.getCount(), 5);
+    EXPECT_TRUE(window.isFull());
+    EXPECT_EQ(window[0].getDate(), days[7].getDate());
+    EXPECT_EQ(window[4].getDate(), days[11].getDate());
+    EXPECT_THROW(window[5], std::out_of_range);
+    auto segments = window.segments();
+    EXPECT_EQ(segments[0].size(), 3);
+    EXPECT_EQ(segments[1].size(), 2);
+    EXPECT_EQ(segments[1].front().getDate(), days[10].getDate());
+
+    Forecast expected;
+    for (size_t i = 7; i < days.size(); ++i) expected += days[i];
+    Date from = days[6].getDate(), to = days[11].getDate();
+    EXPECT_EQ(window.findColdestDay(from, to).getDate(), expected.findColdestDay(from, to).getDate());
+    EXPECT_THROW(window.findColdestDay(days[0].getDate(), days[6].getDate()), std::runtime_error);
+    EXPECT_EQ(window.giveAllDaysOfMonth(1).getCount(), 5);
+    Forecast copy = window.toForecast();
+    ASSERT_EQ(copy.getCount(), 5);
+    EXPECT_EQ(copy[0].getDate(), days[7].getDate());
+
+    window.clear();
+    EXPECT_EQ(window.getCount(), 0);
+    EXPECT_THROW(window.findNextSunnyDay(from), std::invalid_argument);
+}
+
 TEST(IOTest, DateOutputInput) {
     Date d(15, 10, 2023);
     std::stringstream ss;
@@ -0,0 +1,199 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "weather_lib.hpp"
+
+using namespace std;
+
+// Генератор синтетических прогнозов в формате data.txt или в двоичном формате.
+//
+// Записи разбиты на блоки по CHUNK_RECORDS; потоки берут блоки по очереди,
+// форматируют их в собственный буфер и записывают в файл строго по порядку
+// номеров блоков. День с номером i зависит только от seed и i
+// (ForecastGenerator), поэтому файл одинаков при любом числе потоков.
+
+namespace {
+
+constexpr size_t CHUNK_RECORDS = 1 << 16;
+
+struct Settings {
+    string output;
+    uint64_t records = 1000000;
+    bool binary = false;
+    unsigned threads = max(1u, thread::hardware_concurrency());
+    GeneratorOptions generator;
+};
+
+void usage(const char* program) {
+    cerr << "Usage: " << program << " <output file> [options]\n"
+         << "  --records N       number of records (default 1000000)\n"
+         << "  --seed N          generator seed (default 42)\n"
+         << "  --start DD.MM.YYYY first date (default 01.01.2000)\n"
+         << "  --span DAYS       wrap dates within DAYS days (default 0: wrap after 31.12.9999)\n"
+         << "  --duplicates R    share of records repeating the previous date, [0, 1)\n"
+         << "  --invalid R       share of records failing WeatherDay::check(), [0, 1]\n"
+         << "  --mean T          mean yearly temperature (default 10)\n"
+         << "  --amplitude T     seasonal amplitude, 0 disables seasonality (default 18)\n"
+         << "  --stations N      records per date, one per station (default 1)\n"
+         << "  --threads N       writer threads (default: all cores)\n"
+         << "  --binary          write BinaryHeader + BinaryRecord instead of text\n";
+}
+
+template <typename Number>
+Number parseNumber(const string& text) {
+    Number value;
+    istringstream in(text);
+    if (!(in >> value) || !in.eof()) throw invalid_argument("INVALID_ARGUMENT(" + text + ")");
+    return value;
+}
+
+Settings parseSettings(int argc, char** argv) {
+    if (argc < 2) throw invalid_argument("NO OUTPUT FILE");
+    Settings settings;
+    settings.output = argv[1];
+    for (int i = 2; i < argc; i++) {
+        string option = argv[i];
+        if (option == "--binary") {
+            settings.binary = true;
+            continue;
+        }
+        if (i + 1 == argc) throw invalid_argument("MISSING VALUE(" + option + ")");
+        string value = argv[++i];
+        GeneratorOptions& generator = settings.generator;
+        if (option == "--records") settings.records = parseNumber<uint64_t>(value);
+        else if (option == "--seed") generator.seed = parseNumber<uint64_t>(value);
+        else if (option == "--span") generator.span_days = parseNumber<uint64_t>(value);
+        else if (option == "--duplicates") generator.duplicate_ratio = parseNumber<double>(value);
+        else if (option == "--invalid") generator.error_ratio = parseNumber<double>(value);
+        else if (option == "--mean") generator.mean_temperature = parseNumber<int>(value);
+        else if (option == "--amplitude") generator.seasonal_amplitude = parseNumber<int>(value);
+        else if (option == "--stations") generator.stations = parseNumber<uint32_t>(value);
+        else if (option == "--threads") settings.threads = max(1u, parseNumber<unsigned>(value));
+        else if (option == "--start") {
+            istringstream in(value);
+            if (!(in >> generator.start)) throw invalid_argument("INVALID_ARGUMENT(" + value + ")");
+        }
+        else throw invalid_argument("UNKNOWN OPTION(" + option + ")");
+    }
+    return settings;
+}
+
+void formatChunk(const ForecastGenerator& generator, uint64_t first, size_t count, bool binary, vector<char>& buffer) {
+    buffer.clear();
+    if (binary) {
+        buffer.resize(count * sizeof(BinaryRecord));
+        for (size_t i = 0; i != count; i++) {
+            BinaryRecord record = toBinaryRecord(generator.at(first + i));
+            memcpy(buffer.data() + i * sizeof(BinaryRecord), &record, sizeof(record));
+        }
+        return;
+    }
+    buffer.resize(count * (MAX_RECORD_LENGTH + 1));
+    char* out = buffer.data();
+    for (size_t i = 0; i != count; i++) {
+        out = formatWeatherDay(generator.at(first + i), out);
+        *out++ = '\n';
+    }
+    buffer.resize(out - buffer.data());
+}
+
+// Пишет все блоки: каждый поток форматирует очередной блок и ждёт своей очереди на запись.
+// При ошибке в любом потоке остальные прекращают работу, а её текст попадает в error.
+bool writeRecords(const Settings& settings, ofstream& file, string& error) {
+    ForecastGenerator generator(settings.generator);
+    uint64_t chunks = (settings.records + CHUNK_RECORDS - 1) / CHUNK_RECORDS;
+    atomic<uint64_t> next_chunk{0};
+    mutex lock;
+    condition_variable turn;
+    uint64_t written = 0;
+    bool failed = false;
+
+    auto fail = [&](const string& message) {
+        lock_guard<mutex> guard(lock);
+        if (!failed) error = message;
+        failed = true;
+        turn.notify_all();
+    };
+    auto worker = [&]() {
+        try {
+            vector<char> buffer;
+            while (true) {
+                uint64_t chunk = next_chunk.fetch_add(1, memory_order_relaxed);
+                if (chunk >= chunks) return;
+                uint64_t first = chunk * CHUNK_RECORDS;
+                size_t count = static_cast<size_t>(min<uint64_t>(CHUNK_RECORDS, settings.records - first));
+                formatChunk(generator, first, count, settings.binary, buffer);
+                unique_lock<mutex> guard(lock);
+                turn.wait(guard, [&]() { return written == chunk || failed; });
+                if (failed) return;
+                if (!file.write(buffer.data(), buffer.size())) {
+                    error = "write error";
+                    failed = true;
+                }
+                written++;
+                turn.notify_all();
+            }
+        } catch (const exception& problem) {
+            fail(problem.what());
+        }
+    };
+    vector<jthread> threads;
+    for (unsigned i = 0; i != settings.threads; i++) threads.emplace_back(worker);
+    threads.clear();
+    return !failed;
+}
+
+}
+
+int main(int argc, char** argv) {
+    Settings settings;
+    try {
+        settings = parseSettings(argc, argv);
+        ForecastGenerator validation(settings.generator);
+    } catch (const exception& error) {
+        cerr << error.what() << "\n";
+        usage(argv[0]);
+        return 2;
+    }
+
+    ofstream file(settings.output, ios::binary | ios::trunc);
+    if (!file.is_open()) {
+        cerr << "Cannot open " << settings.output << "\n";
+        return 1;
+    }
+    if (settings.binary) {
+        BinaryHeader header{};
+        memcpy(header.magic, BINARY_MAGIC, sizeof(BINARY_MAGIC));
+        header.count = settings.records;
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    }
+
+    auto started = chrono::steady_clock::now();
+    string error;
+    bool written = writeRecords(settings, file, error);
+    file.close();
+    if (!written || file.fail()) {
+        cerr << "Failed to write " << settings.output << ": " << (error.empty() ? "write error" : error) << "\n";
+        // Недописанный файл удаляется; устройства и каналы не трогаем
+        error_code ignored;
+        if (filesystem::is_regular_file(settings.output, ignored)) filesystem::remove(settings.output, ignored);
+        return 1;
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - started).count();
+    ifstream result(settings.output, ios::binary | ios::ate);
+    double megabytes = static_cast<double>(result.tellg()) / (1 << 20);
+    cerr << "Wrote " << settings.records << " records (" << megabytes << " MiB) in " << seconds << " s, "
+         << megabytes / seconds << " MiB/s, " << settings.threads << " threads\n";
+    return 0;
+}